@@ -22,3 +22,5 @@ option(BUILD_WRITER_SERVICE "Build writer service" OFF)
 
 option(BUILD_AI_PROVIDERS "Build AI providers extension" ON)
 option(BUILD_WEATHER_PROVIDERS "Build weather providers extension" OFF)
+
+option(BUILD_TOOLS "Build developer tools such as event_replay and audio_bench" OFF)
@@ -0,0 +1,181 @@
+/*******************************************************************************
+**     FileName: HttpClientPool.h
+**    ClassName: HttpClientPool
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/04 10:30
+**  Description: 每个 Provider 共用的长连接 HTTP 客户端池
+*******************************************************************************/
+
+#ifndef HTTPCLIENTPOOL_H
+#define HTTPCLIENTPOOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ai/AIExport.h>
+#include <kernel/EventMetrics.h>
+
+namespace httplib {
+class Client;
+} // namespace httplib
+
+namespace ai {
+
+/**
+ * @brief Counters of an HttpClientPool, see HttpClientPool::stats().
+ */
+struct AI_API HttpClientPoolStats
+{
+    uint64_t requests = 0;
+    uint64_t reusedConnections = 0; // 借出时连接仍然打开，省去了握手
+    uint64_t createdClients = 0;
+    uint64_t overflowClients = 0;  // 池已满时临时创建、用完即关闭的客户端
+    uint64_t evictedIdle = 0;      // 空闲超时被关闭的客户端
+    uint64_t discardedFailed = 0;  // 请求失败后丢弃的客户端
+    uint64_t retiredClients = 0;   // 达到单连接请求数上限后关闭的客户端
+    HistogramSnapshot newConnectionRequests;    // 需要建立连接的请求耗时
+    HistogramSnapshot reusedConnectionRequests; // 复用连接的请求耗时
+
+    double reuseRate() const
+    {
+        return requests == 0 ? 0.0 : double(reusedConnections) / double(requests);
+    }
+
+    /**
+     * @brief Mean extra time of requests that had to connect (DNS, TCP and
+     * TLS when enabled), estimated from the two request histograms.
+     */
+    double connectOverheadMs() const;
+
+    std::string summary() const;
+};
+
+/**
+ * @brief Keep-alive httplib clients to one base URL, shared by all model
+ * executors of a Provider.
+ *
+ * send() lends an idle client (the most recently used one, whose
+ * connection is the most likely to still be open) or creates one, runs
+ * the request and takes the client back. Up to max_connections clients
+ * are kept; requests beyond that run on a temporary client instead of
+ * waiting, so a long request never stalls the voice path.
+ *
+ * Health checks: httplib probes a kept-alive socket before reusing it and
+ * reconnects when the server closed it. On top of that the pool closes
+ * clients idle longer than idle_timeout_ms (servers drop idle keep-alive
+ * connections after a while), drops a client whose request failed, and
+ * retires a client after max_requests_per_connection requests.
+ */
+class AI_API HttpClientPool
+{
+public:
+    struct Options
+    {
+        size_t maxConnections = 4;
+        std::chrono::milliseconds idleTimeout{30000};
+        std::chrono::milliseconds connectTimeout{5000};
+        uint32_t maxRequestsPerConnection = 1000;
+
+        /**
+         * @brief Read the /ai/http_pool keys of the configuration.
+         */
+        static Options load();
+    };
+
+    /**
+     * @brief A client lent by the pool, given back when destroyed.
+     */
+    class AI_API Connection
+    {
+    public:
+        Connection(Connection &&other) noexcept;
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+        Connection &operator=(Connection &&) = delete;
+        ~Connection();
+
+        httplib::Client &client() const;
+        bool reused() const { return m_reused; }
+
+        // 请求成功后调用，未调用时客户端不会放回池中
+        void setSucceeded(bool succeeded) { m_succeeded = succeeded; }
+
+    private:
+        friend class HttpClientPool;
+        struct Entry;
+        Connection(HttpClientPool *pool, std::shared_ptr<Entry> entry,
+                   bool reused, bool pooled);
+
+        HttpClientPool *m_pool;
+        std::shared_ptr<Entry> m_entry;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_reused;
+        bool m_pooled; // false 表示临时客户端，归还时直接关闭
+        bool m_succeeded = false;
+    };
+
+    explicit HttpClientPool(Options options = Options::load());
+    ~HttpClientPool();
+
+    HttpClientPool(const HttpClientPool &) = delete;
+    HttpClientPool &operator=(const HttpClientPool &) = delete;
+
+    /**
+     * @brief Run request(httplib::Client &) on a pooled client to baseUrl.
+     * The result must convert to bool (httplib::Result does), false drops
+     * the client. Thread-safe.
+     */
+    template <typename Request>
+    auto send(const std::string &baseUrl, Request &&request)
+    {
+        Connection connection = acquire(baseUrl);
+        auto result = request(connection.client());
+        connection.setSucceeded(static_cast<bool>(result));
+        return result;
+    }
+
+    /**
+     * @brief Borrow a client directly, for requests that do not fit send().
+     */
+    Connection acquire(const std::string &baseUrl);
+
+    /**
+     * @brief Close all idle clients.
+     */
+    void clear();
+
+    HttpClientPoolStats stats() const;
+
+private:
+    void release(Connection &connection);
+    // 调用时须持有 m_mutex
+    void evictIdleLocked(std::chrono::steady_clock::time_point now);
+    std::shared_ptr<Connection::Entry> createEntry(const std::string &baseUrl);
+
+private:
+    const Options m_options;
+    mutable std::mutex m_mutex;
+    std::string m_baseUrl; // 池中客户端连接的地址，地址变化时清空空闲客户端
+    std::vector<std::shared_ptr<Connection::Entry>> m_idle;
+    size_t m_inUse = 0;
+
+    std::atomic_uint64_t m_requests{0};
+    std::atomic_uint64_t m_reusedConnections{0};
+    std::atomic_uint64_t m_createdClients{0};
+    std::atomic_uint64_t m_overflowClients{0};
+    std::atomic_uint64_t m_evictedIdle{0};
+    std::atomic_uint64_t m_discardedFailed{0};
+    std::atomic_uint64_t m_retiredClients{0};
+    LatencyHistogram m_newConnectionRequests;
+    LatencyHistogram m_reusedConnectionRequests;
+}; // class HttpClientPool
+
+} // namespace ai
+
+#endif // HTTPCLIENTPOOL_H
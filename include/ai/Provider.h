@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <ai/AIExport.h>
+#include <ai/HttpClientPool.h>
 #include <ai/Model.h>
 
 namespace ai {
@@ -47,6 +48,12 @@ public:
         createModel(const std::string &modelName) const; // should be implemented in derived class
     virtual bool serializable() const;                   // should be implemented in derived class
 
+    /**
+     * @brief Keep-alive HTTP clients to getBaseUrl(), shared by the
+     * executors of all models of this provider.
+     */
+    HttpClientPool &httpClientPool() const;
+
 protected:
     friend class ProviderManager;
     std::string m_apiKey;
@@ -54,6 +61,7 @@ protected:
     std::string m_activeModel;
     std::string m_name;
     std::map<std::string, Model::Ptr> m_models;
+    std::shared_ptr<HttpClientPool> m_httpClientPool;
 };
 
 } // namespace ai
@@ -0,0 +1,147 @@
+/*******************************************************************************
+**     FileName: AudioTap.h
+**    ClassName: AudioTap
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/03 09:20
+**  Description: 诊断用的异步录音，后台线程写入按大小/时长轮转的 WAV 文件
+*******************************************************************************/
+
+#ifndef AUDIOTAP_H
+#define AUDIOTAP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kernel/KernelExport.h>
+#include <kernel/SPSCRingBuffer.h>
+
+/**
+ * @brief Records 16-bit PCM for diagnostics without blocking the caller.
+ *
+ * Two ways in: write() copies a continuous stream into a lock-free ring
+ * buffer (one producer thread, e.g. the capture processing thread), and
+ * writeClip() queues a whole utterance, from any thread. A background
+ * thread drains both into WAV files, starting a new file when one reaches
+ * the time or size cap and deleting the oldest files of the same prefix
+ * beyond max_files.
+ *
+ * A session is the stream between start() and stop(), or one clip. Only
+ * keep_percent of the sessions are recorded, the choice is random. If the
+ * writer falls behind by more than buffer_ms, stream samples are dropped
+ * and counted instead of waiting.
+ */
+class KERNEL_API AudioTap
+{
+public:
+    struct Settings
+    {
+        std::string directory;
+        std::string prefix = "tap"; // 文件名前缀，区分不同的录音点
+        int32_t sampleRate = 16000;
+        int32_t channels = 1;
+        int32_t bufferMs = 2000;   // 环形缓冲区时长
+        int32_t maxFileMs = 60000; // 单个文件最长时长，0 表示不限
+        int32_t maxFileKb = 0;     // 单个文件最大大小，0 表示不限
+        int32_t maxFiles = 50;     // 目录中保留的同前缀文件数，0 表示不限
+        int32_t keepPercent = 100; // 录音的会话比例
+
+        /**
+         * @brief Read the /audio/tap keys of the configuration. An empty
+         * directory means <working_dir>/tempAudios.
+         */
+        static Settings load(const std::string &prefix);
+    };
+
+    explicit AudioTap(Settings settings);
+    ~AudioTap();
+
+    AudioTap(const AudioTap &) = delete;
+    AudioTap &operator=(const AudioTap &) = delete;
+
+    /**
+     * @brief Start the writer thread and a stream session.
+     * @return false if the tap is already running or the directory cannot
+     * be created.
+     */
+    bool start();
+
+    /**
+     * @brief Write what is still buffered, close the files and stop the
+     * writer thread. The stream producer must have stopped writing.
+     */
+    void stop();
+
+    /**
+     * @brief Producer side of the stream: copy samples into the ring
+     * buffer. Never locks or allocates, a no-op if the session is not
+     * recorded or the tap is stopped.
+     */
+    void write(const int16_t *samples, size_t count);
+
+    /**
+     * @brief Queue one utterance to be written to its own file. Thread-safe,
+     * only takes a short lock.
+     */
+    void writeClip(std::vector<int16_t> samples);
+
+    /**
+     * @brief 44-byte header of a PCM WAV file holding dataBytes of audio.
+     */
+    static std::string wavHeader(int32_t sampleRate, int32_t channels,
+                                 int32_t bitsPerSample, uint32_t dataBytes);
+
+    uint64_t droppedSamples() const { return m_droppedSamples.load(); }
+    uint64_t filesWritten() const { return m_filesWritten.load(); }
+    uint64_t keptClips() const { return m_keptClips.load(); }
+    uint64_t skippedClips() const { return m_skippedClips.load(); }
+
+private:
+    struct WavFile
+    {
+        std::ofstream stream;
+        std::string path;
+        size_t samples = 0;
+    };
+
+    void writeLoop();
+    void drainStream();
+    // 按 keep_percent 随机决定一个会话是否录音
+    bool keepSession();
+    // 追加到文件，写满上限时关闭并在下次写入时打开新文件
+    void appendRotating(WavFile &file, const int16_t *samples, size_t count);
+    void closeFile(WavFile &file);
+    void removeOldFiles();
+
+private:
+    const Settings m_settings;
+    size_t m_maxSamplesPerFile = 0; // 0 表示不限
+    uint32_t m_fileIndex = 0;
+    std::mt19937 m_random;
+
+    SPSCRingBuffer<int16_t> m_ring;
+    std::atomic_bool m_recordingStream{false};
+    std::vector<int16_t> m_chunk; // 写线程从环形缓冲区读出的数据
+    WavFile m_streamFile;
+
+    std::thread m_writerThread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<std::vector<int16_t>> m_clips;
+    bool m_running = false;
+
+    std::atomic_uint64_t m_droppedSamples{0};
+    std::atomic_uint64_t m_filesWritten{0};
+    std::atomic_uint64_t m_keptClips{0};
+    std::atomic_uint64_t m_skippedClips{0};
+}; // class AudioTap
+
+#endif // AUDIOTAP_H
@@ -0,0 +1,210 @@
+/*******************************************************************************
+**     FileName: BufferPool.h
+**    ClassName: BufferPool/PooledBuffer
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/01 14:10
+**  Description: 预分配的缓冲区池，缓冲区随事件移交后自动归还
+*******************************************************************************/
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+template <typename T> class BufferPool;
+
+/**
+ * @brief A vector borrowed from a BufferPool.
+ *
+ * Move-only in spirit: moving hands the storage and the way back to the
+ * pool to the new owner, so a buffer can be moved into an event and is
+ * returned, still allocated, when the last copy of that event is
+ * destroyed. Copies are plain vectors that do not belong to any pool. A
+ * default-constructed buffer does not belong to a pool either.
+ */
+template <typename T> class PooledBuffer
+{
+public:
+    PooledBuffer() = default;
+    explicit PooledBuffer(std::vector<T> data) : m_data(std::move(data)) {}
+
+    PooledBuffer(const PooledBuffer &other) : m_data(other.m_data) {}
+    PooledBuffer(PooledBuffer &&other) noexcept
+        : m_data(std::move(other.m_data)), m_pool(std::move(other.m_pool))
+    {
+        other.m_data.clear();
+    }
+
+    PooledBuffer &operator=(const PooledBuffer &other)
+    {
+        if (this != &other)
+        {
+            m_data = other.m_data;
+        }
+        return *this;
+    }
+    PooledBuffer &operator=(PooledBuffer &&other) noexcept
+    {
+        if (this != &other)
+        {
+            giveBack();
+            m_data = std::move(other.m_data);
+            m_pool = std::move(other.m_pool);
+            other.m_data.clear();
+        }
+        return *this;
+    }
+
+    ~PooledBuffer() { giveBack(); }
+
+    std::vector<T> &vector() { return m_data; }
+    const std::vector<T> &vector() const { return m_data; }
+    operator const std::vector<T> &() const { return m_data; }
+
+    size_t size() const { return m_data.size(); }
+    bool empty() const { return m_data.empty(); }
+    void clear() { m_data.clear(); }
+
+    void append(const T *data, size_t count)
+    {
+        m_data.insert(m_data.end(), data, data + count);
+    }
+
+private:
+    friend class BufferPool<T>;
+
+    void giveBack()
+    {
+        if (auto pool = m_pool.lock())
+        {
+            pool->giveBack(std::move(m_data));
+        }
+        m_pool.reset();
+        m_data.clear();
+    }
+
+    std::vector<T> m_data;
+    std::weak_ptr<BufferPool<T>> m_pool;
+}; // class PooledBuffer
+
+/**
+ * @brief Thread-safe pool of vectors with a reserved capacity.
+ *
+ * Buffers are allocated up front; acquire() hands one out and the buffer
+ * comes back by itself when its PooledBuffer is destroyed, on whatever
+ * thread that happens. When the pool is empty a new buffer is allocated
+ * and counted in extraAllocations(), it joins the pool when it is
+ * returned as long as the pool holds fewer than its initial count. A
+ * buffer that outgrew the capacity keeps its larger storage.
+ */
+template <typename T>
+class BufferPool : public std::enable_shared_from_this<BufferPool<T>>
+{
+    struct PrivateTag
+    {
+    };
+
+public:
+    /**
+     * @brief Create a pool of count buffers of capacity elements each.
+     */
+    static std::shared_ptr<BufferPool> create(size_t capacity, size_t count)
+    {
+        return std::make_shared<BufferPool>(PrivateTag{}, capacity, count);
+    }
+
+    BufferPool(PrivateTag, size_t capacity, size_t count)
+        : m_capacity(capacity), m_maxFree(count)
+    {
+        m_free.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_free.emplace_back();
+            m_free.back().reserve(capacity);
+        }
+    }
+
+    BufferPool(const BufferPool &) = delete;
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /**
+     * @brief Take an empty buffer with at least capacity() elements
+     * reserved.
+     */
+    PooledBuffer<T> acquire()
+    {
+        PooledBuffer<T> result;
+        size_t capacity = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            capacity = m_capacity;
+            if (!m_free.empty())
+            {
+                result.m_data = std::move(m_free.back());
+                m_free.pop_back();
+            }
+            else
+            {
+                m_extraAllocations.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (result.m_data.capacity() < capacity)
+        {
+            result.m_data.reserve(capacity);
+        }
+        result.m_pool = this->weak_from_this();
+        return result;
+    }
+
+    /**
+     * @brief Change the capacity reserved for buffers handed out from now
+     * on. Pooled buffers grow when they are acquired, never shrink.
+     */
+    void setCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+    }
+
+    size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_capacity;
+    }
+
+    /**
+     * @brief Buffers allocated because the pool was empty.
+     */
+    uint64_t extraAllocations() const
+    {
+        return m_extraAllocations.load(std::memory_order_relaxed);
+    }
+
+private:
+    friend class PooledBuffer<T>;
+
+    void giveBack(std::vector<T> &&buffer)
+    {
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // 空闲列表预留了初始数量的位置，归还时不会分配内存
+        if (m_free.size() < m_maxFree)
+        {
+            m_free.push_back(std::move(buffer));
+        }
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::vector<T>> m_free;
+    size_t m_capacity;
+    const size_t m_maxFree;
+    std::atomic_uint64_t m_extraAllocations{0};
+}; // class BufferPool
+
+#endif // BUFFERPOOL_H
@@ -9,18 +9,24 @@
 #ifndef EVENTBUS_H
 #define EVENTBUS_H
 
+#include "kernel/EventMetrics.h"
+#include "kernel/Executor.h"
 #include "kernel/Logger.h"
-#include <any>
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
 #include <kernel/KernelExport.h>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <shared_mutex>
+#include <optional>
+#include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
@@ -67,10 +73,111 @@ private:
     bool m_isSubscribed;
 };
 
+/**
+ * @brief What publish_async does when an event type already has as many
+ * pending events as its capacity allows.
+ */
+enum class OverflowPolicy
+{
+    kBlock,      // 发布者等待，直到有事件开始处理（工作线程内发布时不等待）
+    kDropOldest, // 丢弃最早的待处理事件
+    kDropNewest, // 丢弃本次发布的事件
+    kKeepLatest, // 只保留最新的一个待处理事件，之前的全部合并掉
+};
+
+/**
+ * @brief Capacity limit of the pending asynchronous events of one event type.
+ */
+struct QueueLimit
+{
+    // 待处理事件数上限，0 表示不限制
+    size_t capacity = 0;
+    OverflowPolicy policy = OverflowPolicy::kBlock;
+};
+
+/**
+ * @brief Counters of one event type's pending queue.
+ */
+struct QueueStats
+{
+    uint64_t pending = 0;   // 尚未开始处理的事件数
+    uint64_t dropped = 0;   // 因队列已满被丢弃的事件数
+    uint64_t coalesced = 0; // 被更新事件合并掉的事件数
+    uint64_t blocked = 0;   // 发布者因队列已满而等待的次数
+};
+
+/**
+ * @brief Result of EventBus::shutdown().
+ */
+struct ShutdownReport
+{
+    bool drained = true;             // 是否在期限内处理完所有异步事件
+    uint64_t completedTasks = 0;     // 关闭期间处理完成的任务数
+    uint64_t discardedTasks = 0;     // 超过期限仍未处理的任务数，停止 Executor 时丢弃
+    std::chrono::milliseconds elapsed{0}; // 关闭耗时
+};
+
+/**
+ * @brief Stored in the future returned by EventBus::request() when no
+ * responder is registered for the request type.
+ */
+class NoResponderError : public std::runtime_error
+{
+public:
+    explicit NoResponderError(const std::string &requestType)
+        : std::runtime_error("EventBus: no responder for " + requestType)
+    {
+    }
+};
+
+/**
+ * @brief Options controlling how a subscriber receives events.
+ */
+struct SubscriptionOptions
+{
+    // 异步事件的默认执行优先级，可在发布时覆盖（串行订阅除外）
+    EventPriority priority = EventPriority::kInteractive;
+
+    // 串行模式：该订阅者的异步事件在共享线程池上按发布顺序逐个执行，
+    // 回调无需自行加锁
+    bool strand = false;
+
+    SubscriptionOptions &setPriority(EventPriority value)
+    {
+        priority = value;
+        return *this;
+    }
+
+    // 事件类型的待处理队列上限，非空时在订阅时应用到整个事件类型
+    std::optional<QueueLimit> queueLimit;
+
+    // 内联模式：异步发布的事件也在发布线程中直接调用回调，适用于录制、
+    // 统计等必须观察到发布时刻且足够轻量的订阅者
+    bool inlineDelivery = false;
+
+    SubscriptionOptions &setInlineDelivery(bool value)
+    {
+        inlineDelivery = value;
+        return *this;
+    }
+
+    SubscriptionOptions &setStrand(bool value)
+    {
+        strand = value;
+        return *this;
+    }
+
+    SubscriptionOptions &setQueueLimit(size_t capacity, OverflowPolicy policy)
+    {
+        queueLimit = QueueLimit{capacity, policy};
+        return *this;
+    }
+};
+
 class KERNEL_API EventBus
 {
     EventBus();
-    ~EventBus() = default;
+    ~EventBus();
 
 public:
     static EventBus &getInstance();
@@ -83,25 +190,15 @@ public:
      * @brief Subscribe to an event type with a callback.
      * @tparam EventType The type of the event to subscribe to.
      * @param callback The function to call when the event is published.
+     * @param options How the events are delivered to this subscriber.
      * @return A Subscription object. Keep it alive to maintain the
      * subscription.
      */
     template <typename EventType>
-    Subscription on(std::function<void(const EventType &)> callback)
+    Subscription on(std::function<void(const EventType &)> callback,
+                    const SubscriptionOptions &options = SubscriptionOptions())
     {
-        std::unique_lock<std::shared_mutex> lock(m_mutexForSubscription);
-        auto type_index = std::type_index(typeid(EventType));
-        auto subIter = m_subscriptions.find(type_index);
-        if (subIter == m_subscriptions.end())
-        {
-            m_subscriptions[type_index] =
-                std::vector<std::shared_ptr<IEventCallback>>();
-        }
-        auto subscriber = std::make_shared<Subscriber<EventType>>(
-            false, m_nextId++, std::move(callback));
-        m_subscriptions[type_index].push_back(subscriber);
-        return Subscription(
-            std::bind(&EventBus::unsubscribe, this, subscriber->id()));
+        return subscribe<EventType>(false, std::move(callback), options);
     }
 
     /**
@@ -109,25 +206,15 @@ public:
      * once.
      * @tparam EventType The type of the event to subscribe to.
      * @param callback The function to call once when the event is published.
+     * @param options How the events are delivered to this subscriber.
      * @return A Subscription object. It can be ignored if you don't need to
      * unsubscribe manually.
      */
     template <typename EventType>
-    Subscription once(std::function<void(const EventType &)> callback)
+    Subscription once(std::function<void(const EventType &)> callback,
+                      const SubscriptionOptions &options = SubscriptionOptions())
     {
-        std::unique_lock<std::shared_mutex> lock(m_mutexForSubscription);
-        auto type_index = std::type_index(typeid(EventType));
-        auto subIter = m_subscriptions.find(type_index);
-        if (subIter == m_subscriptions.end())
-        {
-            m_subscriptions[type_index] =
-                std::vector<std::shared_ptr<IEventCallback>>();
-        }
-        auto subscriber = std::make_shared<Subscriber<EventType>>(
-            true, m_nextId++, std::move(callback));
-        m_subscriptions[type_index].push_back(subscriber);
-        return Subscription(
-            std::bind(&EventBus::unsubscribe, this, subscriber->id()));
+        return subscribe<EventType>(true, std::move(callback), options);
     }
 
     /**
@@ -139,103 +226,279 @@ public:
      */
     template <typename EventType> void publish(const EventType &event)
     {
-        std::vector<std::shared_ptr<IEventCallback>> callbacksCopy;
+        auto &eventChannel = channel<EventType>();
+        auto subscribers = eventChannel.snapshot();
+        if (isMetricsEnabled())
         {
-            std::shared_lock<std::shared_mutex> lock(m_mutexForSubscription);
-            auto type_index = std::type_index(typeid(EventType));
-            auto iter = m_subscriptions.find(type_index);
-            if (iter == m_subscriptions.end())
-            {
-                return;
-            }
-            callbacksCopy = iter->second;
+            eventChannel.metrics().published.fetch_add(
+                1, std::memory_order_relaxed);
         }
-
-        // Call each callback with the event
-        for (const auto &iter : callbacksCopy)
+        for (const auto &subscriber : *subscribers)
         {
-            iter->invoke(*this, event);
+            deliver(eventChannel, *subscriber, event);
         }
     }
 
     /**
      * @brief Publish an event asynchronously.
-     * The event is queued and processed by a background worker thread.
+     * The event is copied once into an immutable shared holder and every
+     * subscriber task references that single instance.
      * @tparam EventType The type of the event to publish.
-     * @param event The event object to publish. It will be copied into the
-     * queue.
+     * @param event The event object to publish.
+     * @param priority Overrides the priority of every non-strand subscriber,
+     * by default each subscriber runs at its own priority.
      */
-    template <typename EventType> void publish_async(EventType event)
+    template <typename EventType>
+    void publish_async(const EventType &event,
+                       std::optional<EventPriority> priority = std::nullopt)
     {
-        std::vector<std::shared_ptr<IEventCallback>> callbacksCopy;
+        auto &eventChannel = channel<EventType>();
+        auto subscribers = eventChannel.snapshot();
+        if (subscribers->empty())
         {
-            std::shared_lock<std::shared_mutex> lock(m_mutexForSubscription);
-            auto type_index = std::type_index(typeid(EventType));
-            auto iter = m_subscriptions.find(type_index);
-            if (iter == m_subscriptions.end())
-            {
-                return;
-            }
-            callbacksCopy = iter->second;
+            return;
         }
-        for (const auto &iter : callbacksCopy)
+        dispatchAsync(eventChannel, std::move(subscribers),
+                      std::make_shared<const EventType>(event), priority);
+    }
+
+    /**
+     * @brief Publish an event asynchronously, taking ownership of it.
+     * The event is moved into an immutable shared holder, so large payloads
+     * such as PCM buffers are handed off without being copied.
+     * @tparam EventType The type of the event to publish.
+     * @param event The event object to publish.
+     * @param priority Overrides the priority of every non-strand subscriber.
+     */
+    template <typename EventType,
+              typename = std::enable_if_t<!std::is_reference_v<EventType>>>
+    void publish_async(EventType &&event,
+                       std::optional<EventPriority> priority = std::nullopt)
+    {
+        auto &eventChannel = channel<EventType>();
+        auto subscribers = eventChannel.snapshot();
+        if (subscribers->empty())
         {
-            m_workPool.enqueue(
-                [this, iter, event]()
-                {
-                    try
-                    {
-                        iter->invoke(*this, event);
-                    }
-                    catch (const std::exception &e)
-                    {
-                        Logger::logError(
-                            "EventBus: Exception in async callback: %s",
-                            e.what());
-                    }
-                    catch (...)
-                    {
-                        Logger::logError(
-                            "EventBus: Unknown exception in async callback");
-                    }
-                });
+            return;
         }
+        dispatchAsync(eventChannel, std::move(subscribers),
+                      std::make_shared<const EventType>(std::move(event)),
+                      priority);
     }
 
     void unsubscribe(uint64_t id);
 
-private:
-    class IEventCallback
+    /**
+     * @brief Register a responder for a request type.
+     * The handler runs like an asynchronous subscriber (options apply) and
+     * its return value, or the exception it throws, completes the future
+     * of the requester. With several responders the first one wins.
+     * @tparam Request The request type.
+     * @tparam Response The response type, Request::Response by default.
+     * @param handler The function computing the response.
+     * @param options How the requests are delivered to this responder.
+     * @return A Subscription object.
+     */
+    template <typename Request,
+              typename Response = typename Request::Response>
+    Subscription respond(
+        // common_type_t 使 Response 不参与推导，从而可以直接传入 std::bind
+        std::function<std::common_type_t<Response>(const Request &)> handler,
+                         const SubscriptionOptions &options =
+                             SubscriptionOptions())
     {
-    public:
-        virtual ~IEventCallback() = default;
-        virtual uint64_t id() const = 0;
-        virtual void invoke(EventBus &bus, const std::any &event) const = 0;
-    };
+        return on<RequestEnvelope<Request, Response>>(
+            [handler = std::move(handler)](
+                const RequestEnvelope<Request, Response> &envelope)
+            {
+                Reply<Response> &reply = *envelope.reply;
+                if (reply.answered.exchange(true, std::memory_order_acq_rel))
+                {
+                    return;
+                }
+                try
+                {
+                    reply.promise.set_value(handler(envelope.request));
+                }
+                catch (...)
+                {
+                    reply.promise.set_exception(std::current_exception());
+                }
+                reply.runContinuation();
+            },
+            options);
+    }
+
+    /**
+     * @brief Send a request to its responder asynchronously.
+     * The future holds NoResponderError if nobody responds to the type, and
+     * std::future_error (broken_promise) if the request was dropped, e.g.
+     * by a queue limit or after shutdown. Use wait_for() to bound the wait;
+     * several requests can be issued first and joined afterwards. Threads
+     * that must not block (the GUI thread, event handlers) use the
+     * overload taking a callback instead.
+     * @tparam Request The request type.
+     * @tparam Response The response type, Request::Response by default.
+     * @param payload The request object.
+     * @param priority Overrides the priority of the responder.
+     * @return The future of the response.
+     */
+    template <typename Request,
+              typename Response = typename Request::Response>
+    std::future<Response>
+        request(Request payload,
+                std::optional<EventPriority> priority = std::nullopt)
+    {
+        auto reply = std::make_shared<Reply<Response>>();
+        std::future<Response> future = reply->promise.get_future();
+        sendRequest(std::move(payload), std::move(reply), priority);
+        return future;
+    }
+
+    /**
+     * @brief Send a request and pass its future, already ready, to onReply
+     * instead of waiting for it. The future holds the same errors as with
+     * the other overload. onReply runs on the worker that answered, on the
+     * thread releasing a dropped request, or on the calling thread when
+     * nobody responds; it must not block and must not throw.
+     * @param payload The request object.
+     * @param onReply Called exactly once with the ready future.
+     * @param priority Overrides the priority of the responder.
+     */
+    template <typename Request,
+              typename Response = typename Request::Response>
+    void request(
+        Request payload,
+        // common_type_t 使 Response 不参与推导，从而可以直接传入 lambda
+        std::function<void(std::future<std::common_type_t<Response>>)> onReply,
+        std::optional<EventPriority> priority = std::nullopt)
+    {
+        auto reply = std::make_shared<Reply<Response>>();
+        reply->future = reply->promise.get_future();
+        reply->continuation = std::move(onReply);
+        sendRequest(std::move(payload), std::move(reply), priority);
+    }
+
+    /**
+     * @brief Limit the number of pending asynchronous events of a type.
+     * Events stay pending from publish_async until every subscriber task has
+     * started; dropped events release their payload immediately.
+     * @tparam EventType The event type to limit.
+     * @param limit The capacity and overflow policy, capacity 0 removes the
+     * limit.
+     */
+    template <typename EventType> void setQueueLimit(const QueueLimit &limit)
+    {
+        channel<EventType>().pendingQueue().setLimit(limit);
+    }
+
+    /**
+     * @brief Get the pending queue counters of an event type.
+     */
+    template <typename EventType> QueueStats queueStats()
+    {
+        return channel<EventType>().pendingQueue().stats();
+    }
+
+    /**
+     * @brief Wait until every asynchronous event published so far, including
+     * the ones its handlers publish in turn, has been processed.
+     * Must not be called from an event handler running on the pool.
+     * @param timeout The maximum time to wait.
+     * @return true if all events were processed before the timeout.
+     */
+    bool flush(std::chrono::milliseconds timeout =
+                   std::chrono::milliseconds::max());
+
+    /**
+     * @brief Drain pending asynchronous events and stop accepting new ones.
+     * New asynchronous events are still accepted while draining so that
+     * handlers can finish their chains. After shutdown publish_async drops
+     * events and publish keeps working synchronously.
+     *
+     * The bus does not own its Executor, which other components share for
+     * tasks and timers, so the workers keep running. Whoever owns the
+     * process lifetime (ServiceManager::unloadSystemServices) stops the
+     * Executor afterwards; tasks still queued past the deadline are
+     * discarded then.
+     * @param deadline The maximum time spent draining.
+     * @return What was drained and discarded, also written to the log.
+     */
+    ShutdownReport shutdown(std::chrono::milliseconds deadline);
+
+    /**
+     * @brief Configure metrics collection and the periodic JSON dump.
+     * When disabled, dispatch only pays for one relaxed atomic load.
+     */
+    void setMetricsOptions(const MetricsOptions &options);
 
-    template <typename EventType> class Subscriber : public IEventCallback
+    /**
+     * @brief Take a snapshot of the per event type and per subscriber
+     * metrics collected since metrics were enabled.
+     */
+    EventBusMetrics metrics();
+
+    /**
+     * @brief Write the current metrics snapshot to the log as JSON.
+     */
+    void dumpMetrics();
+
+private:
+    class Strand;
+
+    template <typename EventType> class Subscriber
     {
     public:
         Subscriber(bool once, uint64_t id,
-                   std::function<void(const EventType &)> callback)
-            : m_once(once), m_id(id), m_callback(std::move(callback))
+                   std::function<void(const EventType &)> callback,
+                   EventPriority priority, std::shared_ptr<Strand> strand,
+                   bool inlineDelivery)
+            : m_once(once), m_id(id), m_callback(std::move(callback)),
+              m_priority(priority), m_strand(std::move(strand)),
+              m_inlineDelivery(inlineDelivery)
         {
         }
 
-        uint64_t id() const override { return m_id; }
+        uint64_t id() const { return m_id; }
+
+        EventPriority priority() const { return m_priority; }
+
+        // 非串行订阅者返回 nullptr
+        Strand *strand() const { return m_strand.get(); }
 
-        void invoke(EventBus &bus, const std::any &event) const override
+        bool isInlineDelivery() const { return m_inlineDelivery; }
+
+        bool isActive() const { return m_active.load(std::memory_order_acquire); }
+
+        // 标记订阅者失效，之后的分发都会跳过它
+        void deactivate() const
         {
-            try
+            m_active.store(false, std::memory_order_release);
+        }
+
+        LatencyHistogram &execution() const { return m_execution; }
+
+        std::atomic_uint64_t &slowCalls() const { return m_slowCalls; }
+
+        // 返回回调是否被调用，已失效的订阅者会被跳过
+        bool invoke(EventBus &bus, const EventType &event) const
+        {
+            if (m_once)
             {
-                const EventType &const_event =
-                    std::any_cast<const EventType &>(event);
-                m_callback(const_event);
-                if (m_once)
+                // 只有抢到失效标记的分发才会调用 once 回调
+                if (!m_active.exchange(false, std::memory_order_acq_rel))
                 {
-                    bus.unsubscribe(id());
+                    return false;
                 }
             }
+            else if (!isActive())
+            {
+                return false;
+            }
+            try
+            {
+                m_callback(event);
+            }
             catch (const std::exception &e)
             {
                 Logger::logError("EventBus: Exception in async callback: {}",
@@ -246,14 +509,485 @@ private:
                 Logger::logError(
                     "EventBus: Unknown exception in async callback");
             }
+            if (m_once)
+            {
+                bus.unsubscribe(id());
+            }
+            return true;
         }
 
     private:
         bool m_once;
         uint64_t m_id;
         std::function<void(const EventType &)> m_callback;
+        EventPriority m_priority;
+        std::shared_ptr<Strand> m_strand;
+        bool m_inlineDelivery;
+        mutable std::atomic_bool m_active{true};
+        mutable LatencyHistogram m_execution;
+        mutable std::atomic_uint64_t m_slowCalls{0};
+    };
+
+    // 请求的应答状态，被丢弃的请求释放后 future 得到 broken_promise
+    template <typename Response> struct Reply
+    {
+        std::promise<Response> promise;
+        std::atomic_bool answered{false};
+        // 带回调的请求：future 由这里持有，应答后交给回调
+        std::future<Response> future;
+        std::function<void(std::future<Response>)> continuation;
+
+        ~Reply()
+        {
+            if (continuation && !answered.load(std::memory_order_acquire))
+            {
+                // 请求被丢弃，没有应答者会调用回调
+                promise.set_exception(std::make_exception_ptr(
+                    std::future_error(std::future_errc::broken_promise)));
+                runContinuation();
+            }
+        }
+
+        void runContinuation()
+        {
+            if (!continuation)
+            {
+                return;
+            }
+            auto callback = std::move(continuation);
+            continuation = nullptr;
+            try
+            {
+                callback(std::move(future));
+            }
+            catch (const std::exception &e)
+            {
+                Logger::logError("EventBus: request callback threw: {}",
+                                 e.what());
+            }
+        }
+    };
+
+    // 请求在总线上以普通事件的形式传递
+    template <typename Request, typename Response> struct RequestEnvelope
+    {
+        Request request;
+        std::shared_ptr<Reply<Response>> reply;
+    };
+
+    template <typename Request, typename Response>
+    void sendRequest(Request payload, std::shared_ptr<Reply<Response>> reply,
+                     std::optional<EventPriority> priority)
+    {
+        auto &eventChannel = channel<RequestEnvelope<Request, Response>>();
+        auto subscribers = eventChannel.snapshot();
+        if (subscribers->empty())
+        {
+            reply->answered.store(true, std::memory_order_release);
+            reply->promise.set_exception(std::make_exception_ptr(
+                NoResponderError(typeid(Request).name())));
+            reply->runContinuation();
+            return;
+        }
+        dispatchAsync(eventChannel, std::move(subscribers),
+                      std::make_shared<const RequestEnvelope<Request, Response>>(
+                          RequestEnvelope<Request, Response>{
+                              std::move(payload), std::move(reply)}),
+                      priority);
+    }
+
+    // 订阅者在通道中的位置发生变化时的记录：(订阅 id, 新位置)，新位置为
+    // kInvalidSlot 表示订阅者已被移出通道
+    using SlotRelocations = std::vector<std::pair<uint64_t, size_t>>;
+    static constexpr size_t kInvalidSlot = static_cast<size_t>(-1);
+
+    /**
+     * @brief Bounded window of the pending asynchronous events of one event
+     * type, enforcing its QueueLimit.
+     *
+     * Each admitted event gets a ticket that every subscriber task claims
+     * before running. Evicted tickets drop their event, so the payload is
+     * released at once and the remaining tasks skip it.
+     */
+    class KERNEL_API PendingQueue
+    {
+    public:
+        struct Ticket
+        {
+            std::shared_ptr<const void> event;
+            size_t remainingTasks;
+        };
+
+        bool isBounded() const
+        {
+            return m_bounded.load(std::memory_order_acquire);
+        }
+
+        void setLimit(const QueueLimit &limit);
+
+        // 登记一个待处理事件，被丢弃时返回 nullptr
+        std::shared_ptr<Ticket> admit(std::shared_ptr<const void> event,
+                                      size_t taskCount);
+
+        // 任务开始执行时调用，事件已被丢弃或合并时返回 nullptr
+        std::shared_ptr<const void> claim(Ticket &ticket);
+
+        QueueStats stats();
+
+    private:
+        void evict(const std::shared_ptr<Ticket> &ticket);
+
+    private:
+        std::atomic_bool m_bounded{false};
+        std::mutex m_mutex;
+        std::condition_variable m_condForSpace;
+        QueueLimit m_limit;
+        std::deque<std::shared_ptr<Ticket>> m_tickets;
+        QueueStats m_stats;
+    };
+
+    // 事件类型级别的指标，仅在启用指标时更新
+    struct ChannelMetrics
+    {
+        std::atomic_uint64_t published{0};
+        std::atomic_uint64_t pending{0};
+        std::atomic_uint64_t rejected{0}; // 线程池队列已满而未能提交的任务数
+        LatencyHistogram queueDelay;
+        LatencyHistogram execution;
+    };
+
+    class IChannel
+    {
+    public:
+        virtual ~IChannel() = default;
+
+        ChannelMetrics &metrics() { return m_metrics; }
+
+        // 填充该事件类型的指标，调用方需持有 m_mutexForSubscription
+        virtual void collectMetrics(EventTypeMetrics &metrics) = 0;
+
+        // 以下接口调用方需持有 m_mutexForSubscription
+        // 将 slot 处 id 对应的订阅者标记为失效，失效项过多时压缩列表，
+        // 位置变化的订阅者通过 relocations 返回
+        virtual void remove(size_t slot, uint64_t id,
+                            SlotRelocations &relocations) = 0;
+
+    protected:
+        ChannelMetrics m_metrics;
+    };
+
+    /**
+     * @brief Statically typed channel holding the subscribers of one event
+     * type.
+     *
+     * The subscriber list is copy-on-write: publishers atomically load the
+     * current snapshot, subscribing copies and swaps it while holding
+     * m_mutexForSubscription. Unsubscribing only marks the slot inactive;
+     * the list is compacted once inactive slots make up half of it.
+     */
+    template <typename EventType> class Channel : public IChannel
+    {
+    public:
+        using SubscriberList =
+            std::vector<std::shared_ptr<const Subscriber<EventType>>>;
+
+        std::shared_ptr<const SubscriberList> snapshot() const
+        {
+            return std::atomic_load(&m_subscribers);
+        }
+
+        PendingQueue &pendingQueue() { return m_pendingQueue; }
+
+        size_t add(std::shared_ptr<const Subscriber<EventType>> subscriber)
+        {
+            auto subscribers = std::make_shared<SubscriberList>(*m_subscribers);
+            subscribers->push_back(std::move(subscriber));
+            size_t slot = subscribers->size() - 1;
+            store(std::move(subscribers));
+            return slot;
+        }
+
+        void remove(size_t slot, uint64_t id,
+                    SlotRelocations &relocations) override
+        {
+            if (slot >= m_subscribers->size() ||
+                (*m_subscribers)[slot]->id() != id)
+            {
+                return;
+            }
+            (*m_subscribers)[slot]->deactivate();
+            if (++m_inactiveCount * 2 < m_subscribers->size())
+            {
+                return;
+            }
+
+            auto subscribers = std::make_shared<SubscriberList>();
+            subscribers->reserve(m_subscribers->size() - m_inactiveCount);
+            for (size_t i = 0; i < m_subscribers->size(); ++i)
+            {
+                const auto &subscriber = (*m_subscribers)[i];
+                if (!subscriber->isActive())
+                {
+                    // once 订阅者可能已失效但尚未取消订阅，一并从索引移除
+                    relocations.emplace_back(subscriber->id(), kInvalidSlot);
+                    continue;
+                }
+                if (i != subscribers->size())
+                {
+                    relocations.emplace_back(subscriber->id(),
+                                             subscribers->size());
+                }
+                subscribers->push_back(subscriber);
+            }
+            m_inactiveCount = 0;
+            store(std::move(subscribers));
+        }
+
+        void collectMetrics(EventTypeMetrics &metrics) override
+        {
+            metrics.published = m_metrics.published.load();
+            metrics.pending = m_metrics.pending.load();
+            QueueStats queueStats = m_pendingQueue.stats();
+            metrics.dropped = queueStats.dropped + m_metrics.rejected.load();
+            metrics.coalesced = queueStats.coalesced;
+            metrics.queueDelay = m_metrics.queueDelay.snapshot();
+            metrics.execution = m_metrics.execution.snapshot();
+            for (const auto &subscriber : *m_subscribers)
+            {
+                if (subscriber->isActive())
+                {
+                    metrics.subscribers.push_back(
+                        {subscriber->id(), subscriber->slowCalls().load(),
+                         subscriber->execution().snapshot()});
+                }
+            }
+        }
+
+    private:
+        void store(std::shared_ptr<SubscriberList> subscribers)
+        {
+            std::atomic_store(&m_subscribers,
+                              std::shared_ptr<const SubscriberList>(
+                                  std::move(subscribers)));
+        }
+
+    private:
+        std::shared_ptr<const SubscriberList> m_subscribers =
+            std::make_shared<const SubscriberList>();
+        size_t m_inactiveCount = 0;
+        PendingQueue m_pendingQueue;
+    };
+
+    /**
+     * @brief Resolve the channel of an event type.
+     *
+     * Channels are owned by the kernel so that every module sees the same
+     * instance; each module only looks its channel up once and caches the
+     * pointer, so dispatch never hashes a type_index.
+     */
+    template <typename EventType> Channel<EventType> &channel()
+    {
+        static Channel<EventType> *cached =
+            &static_cast<Channel<EventType> &>(resolveChannel(
+                std::type_index(typeid(EventType)),
+                []() -> std::unique_ptr<IChannel>
+                { return std::make_unique<Channel<EventType>>(); }));
+        return *cached;
+    }
+
+    IChannel &resolveChannel(std::type_index type,
+                             std::unique_ptr<IChannel> (*factory)());
+
+    template <typename EventType>
+    Subscription subscribe(bool once,
+                           std::function<void(const EventType &)> callback,
+                           const SubscriptionOptions &options)
+    {
+        auto &eventChannel = channel<EventType>();
+        if (options.queueLimit)
+        {
+            eventChannel.pendingQueue().setLimit(*options.queueLimit);
+        }
+        auto subscriber = std::make_shared<const Subscriber<EventType>>(
+            once, m_nextId++, std::move(callback), options.priority,
+            options.strand && !options.inlineDelivery
+                ? std::make_shared<Strand>(m_executor, options.priority)
+                : nullptr,
+            options.inlineDelivery);
+        {
+            std::lock_guard<std::mutex> lock(m_mutexForSubscription);
+            size_t slot = eventChannel.add(subscriber);
+            m_subscriptionIndex[subscriber->id()] = {&eventChannel, slot};
+        }
+        return Subscription(
+            std::bind(&EventBus::unsubscribe, this, subscriber->id()));
+    }
+
+    template <typename EventType>
+    void dispatchAsync(
+        Channel<EventType> &eventChannel,
+        std::shared_ptr<const typename Channel<EventType>::SubscriberList>
+            subscribers,
+        std::shared_ptr<const EventType> event,
+        std::optional<EventPriority> priority)
+    {
+        if (m_isShutdown.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // 发布时刻仅在启用指标时读取，用于统计排队延迟
+        bool measured = isMetricsEnabled();
+        std::chrono::steady_clock::time_point publishTime;
+        if (measured)
+        {
+            publishTime = std::chrono::steady_clock::now();
+            eventChannel.metrics().published.fetch_add(
+                1, std::memory_order_relaxed);
+        }
+
+        // 内联订阅者在发布线程中直接调用，其余订阅者各对应一个任务
+        size_t taskCount = 0;
+        for (const auto &subscriber : *subscribers)
+        {
+            if (subscriber->isInlineDelivery())
+            {
+                deliver(eventChannel, *subscriber, *event);
+            }
+            else
+            {
+                ++taskCount;
+            }
+        }
+        if (taskCount == 0)
+        {
+            return;
+        }
+
+        // 受限的事件类型：任务只持有票据，事件被丢弃时负载立即释放
+        std::shared_ptr<PendingQueue::Ticket> ticket;
+        PendingQueue &pendingQueue = eventChannel.pendingQueue();
+        if (pendingQueue.isBounded())
+        {
+            ticket = pendingQueue.admit(event, taskCount);
+            if (!ticket)
+            {
+                return;
+            }
+            event.reset();
+        }
+        if (measured)
+        {
+            eventChannel.metrics().pending.fetch_add(
+                taskCount, std::memory_order_relaxed);
+        }
+
+        // 任务持有订阅者快照，保证订阅者在执行期间不会被释放
+        for (const auto &iter : *subscribers)
+        {
+            const Subscriber<EventType> *subscriber = iter.get();
+            if (subscriber->isInlineDelivery())
+            {
+                continue;
+            }
+            m_inFlightTasks.fetch_add(1, std::memory_order_relaxed);
+            auto task = [this, subscribers, subscriber, event, ticket,
+                         &eventChannel, measured, publishTime]()
+            {
+                InFlightGuard guard(*this);
+                if (measured)
+                {
+                    ChannelMetrics &metrics = eventChannel.metrics();
+                    metrics.pending.fetch_sub(1, std::memory_order_relaxed);
+                    metrics.queueDelay.record(std::chrono::steady_clock::now() -
+                                              publishTime);
+                }
+                if (!ticket)
+                {
+                    deliver(eventChannel, *subscriber, *event);
+                    return;
+                }
+                auto claimed = std::static_pointer_cast<const EventType>(
+                    eventChannel.pendingQueue().claim(*ticket));
+                if (claimed)
+                {
+                    deliver(eventChannel, *subscriber, *claimed);
+                }
+            };
+            if (subscriber->strand())
+            {
+                subscriber->strand()->post(std::move(task));
+            }
+            else if (!m_executor.submit(
+                         std::move(task),
+                         priority.value_or(subscriber->priority())))
+            {
+                // 任务被线程池拒绝（工作线程发布且队列已满，或已停止），按丢弃处理
+                ChannelMetrics &metrics = eventChannel.metrics();
+                metrics.rejected.fetch_add(1, std::memory_order_relaxed);
+                if (measured)
+                {
+                    metrics.pending.fetch_sub(1, std::memory_order_relaxed);
+                }
+                if (ticket)
+                {
+                    pendingQueue.claim(*ticket);
+                }
+                finishTask();
+            }
+        }
+    }
+
+    bool isMetricsEnabled() const
+    {
+        return m_metricsEnabled.load(std::memory_order_relaxed);
+    }
+
+    // 调用订阅者，启用指标时记录执行耗时并检查慢回调
+    template <typename EventType>
+    void deliver(Channel<EventType> &eventChannel,
+                 const Subscriber<EventType> &subscriber,
+                 const EventType &event)
+    {
+        if (!isMetricsEnabled())
+        {
+            subscriber.invoke(*this, event);
+            return;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        if (!subscriber.invoke(*this, event))
+        {
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        eventChannel.metrics().execution.record(elapsed);
+        subscriber.execution().record(elapsed);
+        auto threshold = std::chrono::microseconds(
+            m_slowCallbackMicroseconds.load(std::memory_order_relaxed));
+        if (threshold.count() > 0 && elapsed > threshold)
+        {
+            subscriber.slowCalls().fetch_add(1, std::memory_order_relaxed);
+            reportSlowCallback(std::type_index(typeid(EventType)),
+                               subscriber.id(), elapsed);
+        }
+    }
+
+    void reportSlowCallback(std::type_index type, uint64_t id,
+                            std::chrono::steady_clock::duration elapsed);
+
+    void stopMetricsDump();
+
+    // 任务结束（包括跳过已丢弃的事件）时减少进行中的任务计数
+    struct InFlightGuard
+    {
+        explicit InFlightGuard(EventBus &bus) : m_bus(bus) {}
+        ~InFlightGuard() { m_bus.finishTask(); }
+
+        EventBus &m_bus;
     };
 
+    void finishTask();
+
     struct IEventHolder
     {
         virtual ~IEventHolder() = default;
@@ -284,34 +1018,65 @@ private:
         bool m_async;
     };
 
-    class KERNEL_API WorkPool
+    /**
+     * @brief Serializes tasks on top of the Executor.
+     *
+     * At most one drain task of a strand is queued or running at a time, so
+     * tasks posted to it run one after another in posting order without a
+     * dedicated thread.
+     */
+    class KERNEL_API Strand : public std::enable_shared_from_this<Strand>
     {
     public:
-        WorkPool(uint32_t numWorkers = std::thread::hardware_concurrency());
-        ~WorkPool();
+        Strand(Executor &executor, EventPriority priority);
 
-        void enqueue(std::function<void()> task);
-        void stop();
+        void post(std::function<void()> task);
 
     private:
-        void processTask();
+        // 提交排空任务，线程池拒绝时交给定时线程提交
+        void schedule();
+        void drain();
 
     private:
-        std::vector<std::thread> m_workers;
-        std::queue<std::function<void()>> m_taskQueue;
-        std::mutex m_mutexForTaskQueue;
-        std::condition_variable m_condForTaskQueue;
-        std::atomic_bool m_stop;
+        // 单次最多连续执行的任务数，超过后重新排队，避免长期占用工作线程
+        static constexpr size_t kMaxBatchSize = 16;
+
+        Executor &m_executor;
+        EventPriority m_priority;
+        std::mutex m_mutex;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_scheduled = false;
     };
 
 private:
     std::atomic_uint64_t m_nextId{0};
-    std::shared_mutex m_mutexForSubscription;
-    std::unordered_map<std::type_index,
-                       std::vector<std::shared_ptr<IEventCallback>>>
-        m_subscriptions;
-    std::thread m_workerThread;
-    WorkPool m_workPool;
+    // 仅用于订阅/取消订阅之间的互斥，发布路径不加锁
+    std::mutex m_mutexForSubscription;
+    std::unordered_map<std::type_index, std::unique_ptr<IChannel>> m_channels;
+
+    struct SubscriptionSlot
+    {
+        IChannel *channel;
+        size_t slot;
+    };
+    // 订阅 id 到 (通道, 位置) 的索引，取消订阅无需遍历
+    std::unordered_map<uint64_t, SubscriptionSlot> m_subscriptionIndex;
+
+    std::atomic_bool m_metricsEnabled{false};
+    std::atomic_int64_t m_slowCallbackMicroseconds{0};
+    // 定期输出指标快照的线程
+    std::thread m_metricsDumpThread;
+    std::mutex m_mutexForMetricsDump;
+    std::condition_variable m_condForMetricsDump;
+    bool m_stopMetricsDump = false;
+
+    // 已投递但尚未执行完成的异步任务数，用于 flush 与 shutdown
+    std::atomic_uint64_t m_inFlightTasks{0};
+    std::atomic_uint64_t m_completedTasks{0};
+    std::atomic_bool m_isShutdown{false};
+    std::mutex m_mutexForFlush;
+    std::condition_variable m_condForFlush;
+    Executor &m_executor;
 };
 
 #endif // EVENTBUS_H
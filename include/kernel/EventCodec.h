@@ -0,0 +1,367 @@
+/*******************************************************************************
+**     FileName: EventCodec.h
+**    ClassName: BinaryWriter/BinaryReader
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/27 20:05
+**  Description: 事件的紧凑二进制编解码，用于事件录制与回放
+*******************************************************************************/
+
+#ifndef EVENTCODEC_H
+#define EVENTCODEC_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <kernel/Events.h>
+
+/**
+ * @brief Appends values to a byte buffer in host byte order.
+ *
+ * Strings and vectors are written as a uint32 length followed by their
+ * elements; vectors of arithmetic types are copied in one block.
+ */
+class BinaryWriter
+{
+public:
+    explicit BinaryWriter(std::string &buffer) : m_buffer(buffer) {}
+
+    template <typename... Args> void operator()(Args &...args)
+    {
+        (write(args), ...);
+    }
+
+private:
+    template <typename T> void write(const T &value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            write(static_cast<std::underlying_type_t<T>>(value));
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            m_buffer.append(reinterpret_cast<const char *>(&value),
+                            sizeof(value));
+        }
+        else
+        {
+            serialize(*this, const_cast<T &>(value));
+        }
+    }
+
+    template <typename Clock, typename Duration>
+    void write(const std::chrono::time_point<Clock, Duration> &value)
+    {
+        write(static_cast<int64_t>(value.time_since_epoch().count()));
+    }
+
+    void write(const std::string &value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        m_buffer.append(value);
+    }
+
+    template <typename T> void write(const std::vector<T> &value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            m_buffer.append(reinterpret_cast<const char *>(value.data()),
+                            value.size() * sizeof(T));
+        }
+        else
+        {
+            for (const auto &item : value)
+            {
+                write(item);
+            }
+        }
+    }
+
+    std::string &m_buffer;
+};
+
+/**
+ * @brief Reads values written by BinaryWriter. Reading past the end marks
+ * the reader as failed and leaves the remaining values untouched.
+ */
+class BinaryReader
+{
+public:
+    BinaryReader(const char *data, size_t size) : m_data(data), m_size(size)
+    {
+    }
+
+    bool ok() const { return m_ok; }
+
+    template <typename... Args> void operator()(Args &...args)
+    {
+        (read(args), ...);
+    }
+
+private:
+    bool take(void *target, size_t size)
+    {
+        if (!m_ok || m_size - m_offset < size)
+        {
+            m_ok = false;
+            return false;
+        }
+        std::memcpy(target, m_data + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    template <typename T> void read(T &value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            std::underlying_type_t<T> raw{};
+            read(raw);
+            value = static_cast<T>(raw);
+        }
+        else if constexpr (std::is_arithmetic_v<T>)
+        {
+            take(&value, sizeof(value));
+        }
+        else
+        {
+            serialize(*this, value);
+        }
+    }
+
+    template <typename Clock, typename Duration>
+    void read(std::chrono::time_point<Clock, Duration> &value)
+    {
+        int64_t count = 0;
+        read(count);
+        value = std::chrono::time_point<Clock, Duration>(Duration(count));
+    }
+
+    void read(std::string &value)
+    {
+        uint32_t size = 0;
+        read(size);
+        if (m_ok && m_size - m_offset >= size)
+        {
+            value.assign(m_data + m_offset, size);
+            m_offset += size;
+        }
+        else
+        {
+            m_ok = false;
+        }
+    }
+
+    template <typename T> void read(std::vector<T> &value)
+    {
+        uint32_t size = 0;
+        read(size);
+        if constexpr (std::is_arithmetic_v<T>)
+        {
+            if (!m_ok || (m_size - m_offset) / sizeof(T) < size)
+            {
+                m_ok = false;
+                return;
+            }
+            value.resize(size);
+            take(value.data(), size * sizeof(T));
+        }
+        else
+        {
+            value.clear();
+            for (uint32_t i = 0; i < size && m_ok; ++i)
+            {
+                value.emplace_back();
+                read(value.back());
+            }
+        }
+    }
+
+    const char *m_data;
+    size_t m_size;
+    size_t m_offset = 0;
+    bool m_ok = true;
+};
+
+// ============== 实体与事件的字段列表 ==============
+// 同一个 serialize 同时用于编码与解码，新增字段只能追加在末尾
+
+template <typename Archive> void serialize(Archive &archive, Todo &todo)
+{
+    archive(todo.id, todo.title, todo.content, todo.dueTime,
+            todo.reminderTime, todo.priority, todo.status, todo.createdAt,
+            todo.updatedAt);
+}
+
+template <typename Archive> void serialize(Archive &archive, WeatherInfo &info)
+{
+    archive(info.province, info.city, info.weather, info.temp,
+            info.windDirection, info.windPower, info.humidity,
+            info.reportTime);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, SystemEvents::SystemMessageEvent &event)
+{
+    archive(event.time, event.message);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, AudioEvents::CheckIsWakewordEvent &event)
+{
+    archive(event.time, event.audioData.vector());
+}
+
+template <typename Archive>
+void serialize(Archive &archive,
+               AudioEvents::AudioContentRecordingDoneEvent &event)
+{
+    archive(event.time, event.audioData.vector());
+}
+
+template <typename Archive>
+void serialize(Archive &archive, AudioEvents::AudioSliceEvent &event)
+{
+    archive(event.time, event.type, event.audio_data);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, WeatherEvents::WeatherUpdatedEvent &event)
+{
+    archive(event.time, event.city, event.weather_info);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, WeatherEvents::WeatherRequestEvent &event)
+{
+    archive(event.time);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, AIEvents::ValidWakeWordEvent &event)
+{
+    archive(event.time);
+}
+
+template <typename Archive>
+void serialize(Archive &archive,
+               AIEvents::SpeechRecognitionResultReadyEvent &event)
+{
+    archive(event.time, event.result);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, AIEvents::AIAgentDoneEvent &event)
+{
+    archive(event.time, event.result);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::CreateTodoEvent &event)
+{
+    archive(event.time, event.item);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::TodoCreatedEvent &event)
+{
+    archive(event.time, event.item);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::DeleteTodoEvent &event)
+{
+    archive(event.time, event.id, event.title);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::TodoDeletedEvent &event)
+{
+    archive(event.time, event.id, event.title);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::UpdateTodoEvent &event)
+{
+    archive(event.time, event.id, event.title, event.item);
+}
+
+template <typename Archive>
+void serialize(Archive &archive, TodoEvents::TodoUpdatedEvent &event)
+{
+    archive(event.time, event.item);
+}
+
+// ============== 可录制的事件类型 ==============
+// 携带回调（std::function）的请求类事件无法序列化，不参与录制
+
+/**
+ * @brief Stable on-disk id of a recordable event type. Ids must never be
+ * reused once a recording format has shipped.
+ *
+ * derived marks events that a service or the AI publishes in reaction to
+ * another recorded event (TodoCreatedEvent after CreateTodoEvent,
+ * ValidWakeWordEvent after CheckIsWakewordEvent, ...). They are recorded
+ * so that a log shows the whole session, but EventReplayer skips them by
+ * default: replaying them next to their source events would deliver them
+ * twice.
+ */
+template <typename EventType> struct RecordedEventId;
+
+#define GA_RECORDED_EVENT(EventType, Id, Derived)                             \
+    template <> struct RecordedEventId<EventType>                              \
+    {                                                                          \
+        static constexpr uint16_t value = Id;                                  \
+        static constexpr bool derived = Derived;                               \
+    };
+
+GA_RECORDED_EVENT(SystemEvents::SystemMessageEvent, 1, true)
+GA_RECORDED_EVENT(AudioEvents::CheckIsWakewordEvent, 2, false)
+GA_RECORDED_EVENT(AudioEvents::AudioContentRecordingDoneEvent, 3, false)
+GA_RECORDED_EVENT(AudioEvents::AudioSliceEvent, 4, false)
+GA_RECORDED_EVENT(WeatherEvents::WeatherUpdatedEvent, 5, true)
+GA_RECORDED_EVENT(WeatherEvents::WeatherRequestEvent, 6, false)
+GA_RECORDED_EVENT(AIEvents::ValidWakeWordEvent, 7, true)
+GA_RECORDED_EVENT(AIEvents::SpeechRecognitionResultReadyEvent, 8, true)
+GA_RECORDED_EVENT(AIEvents::AIAgentDoneEvent, 9, true)
+GA_RECORDED_EVENT(TodoEvents::CreateTodoEvent, 10, false)
+GA_RECORDED_EVENT(TodoEvents::TodoCreatedEvent, 11, true)
+GA_RECORDED_EVENT(TodoEvents::DeleteTodoEvent, 12, false)
+GA_RECORDED_EVENT(TodoEvents::TodoDeletedEvent, 13, true)
+GA_RECORDED_EVENT(TodoEvents::UpdateTodoEvent, 14, false)
+GA_RECORDED_EVENT(TodoEvents::TodoUpdatedEvent, 15, true)
+
+#undef GA_RECORDED_EVENT
+
+template <typename EventType> struct EventTag
+{
+    using type = EventType;
+};
+
+/**
+ * @brief Call visitor(EventTag<T>()) for every recordable event type.
+ */
+template <typename Visitor> void forEachRecordedEvent(Visitor &&visitor)
+{
+    visitor(EventTag<SystemEvents::SystemMessageEvent>());
+    visitor(EventTag<AudioEvents::CheckIsWakewordEvent>());
+    visitor(EventTag<AudioEvents::AudioContentRecordingDoneEvent>());
+    visitor(EventTag<AudioEvents::AudioSliceEvent>());
+    visitor(EventTag<WeatherEvents::WeatherUpdatedEvent>());
+    visitor(EventTag<WeatherEvents::WeatherRequestEvent>());
+    visitor(EventTag<AIEvents::ValidWakeWordEvent>());
+    visitor(EventTag<AIEvents::SpeechRecognitionResultReadyEvent>());
+    visitor(EventTag<AIEvents::AIAgentDoneEvent>());
+    visitor(EventTag<TodoEvents::CreateTodoEvent>());
+    visitor(EventTag<TodoEvents::TodoCreatedEvent>());
+    visitor(EventTag<TodoEvents::DeleteTodoEvent>());
+    visitor(EventTag<TodoEvents::TodoDeletedEvent>());
+    visitor(EventTag<TodoEvents::UpdateTodoEvent>());
+    visitor(EventTag<TodoEvents::TodoUpdatedEvent>());
+}
+
+#endif // EVENTCODEC_H
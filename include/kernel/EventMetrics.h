@@ -0,0 +1,122 @@
+/*******************************************************************************
+**     FileName: EventMetrics.h
+**    ClassName: LatencyHistogram
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/26 14:20
+**  Description: 事件总线的延迟直方图与指标快照
+*******************************************************************************/
+
+#ifndef EVENTMETRICS_H
+#define EVENTMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <kernel/KernelExport.h>
+
+/**
+ * @brief Point-in-time copy of a LatencyHistogram.
+ *
+ * Bucket i counts samples in [2^(i-1), 2^i) microseconds, bucket 0 counts
+ * samples below 1 microsecond.
+ */
+struct KERNEL_API HistogramSnapshot
+{
+    static constexpr size_t kBucketCount = 32;
+
+    uint64_t count = 0;
+    uint64_t totalMicroseconds = 0;
+    uint64_t maxMicroseconds = 0;
+    std::array<uint64_t, kBucketCount> buckets{};
+
+    double meanMicroseconds() const
+    {
+        return count == 0 ? 0.0 : double(totalMicroseconds) / double(count);
+    }
+
+    /**
+     * @brief Upper bound of the bucket holding the given percentile.
+     * @param percentile A value in (0, 100].
+     */
+    uint64_t percentileMicroseconds(double percentile) const;
+};
+
+/**
+ * @brief Lock-free log2 latency histogram.
+ *
+ * Recording is a handful of relaxed atomic increments, so it can be called
+ * from any worker thread on every dispatch.
+ */
+class KERNEL_API LatencyHistogram
+{
+public:
+    void record(std::chrono::steady_clock::duration duration);
+
+    HistogramSnapshot snapshot() const;
+
+private:
+    std::array<std::atomic_uint64_t, HistogramSnapshot::kBucketCount>
+        m_buckets{};
+    std::atomic_uint64_t m_count{0};
+    std::atomic_uint64_t m_totalMicroseconds{0};
+    std::atomic_uint64_t m_maxMicroseconds{0};
+};
+
+/**
+ * @brief Metrics of one subscriber.
+ */
+struct SubscriberMetrics
+{
+    uint64_t id = 0;
+    uint64_t slowCalls = 0;      // 超过慢回调阈值的调用次数
+    HistogramSnapshot execution; // 回调执行耗时
+};
+
+/**
+ * @brief Metrics of one event type.
+ */
+struct EventTypeMetrics
+{
+    std::string name;
+    uint64_t published = 0;       // 同步与异步发布次数
+    uint64_t pending = 0;         // 已投递但尚未开始执行的异步任务数
+    uint64_t dropped = 0;         // 因队列限制或线程池队列已满被丢弃的事件数
+    uint64_t coalesced = 0;       // 因 kKeepLatest 被合并的事件数
+    HistogramSnapshot queueDelay; // 异步发布到开始执行的等待时间
+    HistogramSnapshot execution;  // 所有订阅者回调执行耗时
+    std::vector<SubscriberMetrics> subscribers;
+};
+
+/**
+ * @brief Snapshot of all EventBus metrics, see EventBus::metrics().
+ */
+struct KERNEL_API EventBusMetrics
+{
+    bool enabled = false;
+    uint64_t inFlightTasks = 0;
+    std::vector<EventTypeMetrics> eventTypes;
+
+    /**
+     * @brief Serialize the snapshot, histograms are summarized as
+     * count/mean/p50/p99/max in microseconds.
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @brief Options of EventBus metrics collection.
+ */
+struct MetricsOptions
+{
+    bool enabled = false;
+    // 回调耗时超过该阈值时输出警告，0 表示不检查
+    std::chrono::milliseconds slowCallbackThreshold{0};
+    // 定期将指标快照以 JSON 写入日志的间隔，0 表示不输出
+    std::chrono::milliseconds dumpInterval{0};
+};
+
+#endif // EVENTMETRICS_H
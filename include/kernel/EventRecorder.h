@@ -0,0 +1,120 @@
+/*******************************************************************************
+**     FileName: EventRecorder.h
+**    ClassName: EventRecorder/EventReplayer
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/27 20:40
+**  Description: 事件录制与回放，用于离线复现与性能对比
+*******************************************************************************/
+
+#ifndef EVENTRECORDER_H
+#define EVENTRECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kernel/EventBus.h>
+#include <kernel/KernelExport.h>
+
+/**
+ * @brief Records every published event of the recordable types listed in
+ * EventCodec.h to a binary file.
+ *
+ * File layout: the magic "GAEVREC1", then one record per event:
+ * uint16 type id, uint64 nanoseconds since recording started, uint32
+ * payload size and the payload. Events are observed in the publishing
+ * thread through inline subscriptions and encoded there; a background
+ * thread writes them to disk.
+ */
+class KERNEL_API EventRecorder
+{
+public:
+    explicit EventRecorder(EventBus &bus);
+    ~EventRecorder();
+
+    EventRecorder(const EventRecorder &) = delete;
+    EventRecorder &operator=(const EventRecorder &) = delete;
+
+    /**
+     * @brief Open the file and start recording.
+     * @return false if the file cannot be opened or recording is running.
+     */
+    bool start(const std::string &path);
+
+    /**
+     * @brief Stop recording and flush the remaining records to the file.
+     */
+    void stop();
+
+    uint64_t recordedEvents() const { return m_recordedEvents.load(); }
+
+private:
+    struct Record
+    {
+        uint16_t typeId;
+        uint64_t timestamp;
+        std::string payload;
+    };
+
+    void append(uint16_t typeId, std::string payload);
+    void writeLoop();
+
+private:
+    EventBus &m_bus;
+    std::vector<Subscription> m_subscriptions;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::ofstream m_file;
+    std::thread m_writerThread;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::deque<Record> m_records;
+    bool m_running = false;
+    std::atomic_uint64_t m_recordedEvents{0};
+}; // class EventRecorder
+
+/**
+ * @brief Loads a recording made by EventRecorder and publishes its source
+ * events again, asynchronously and in the original order.
+ */
+class KERNEL_API EventReplayer
+{
+public:
+    struct Record
+    {
+        uint16_t typeId;
+        uint64_t timestamp; // 距录制开始的纳秒数
+        std::string payload;
+    };
+
+    /**
+     * @brief Load a recording file.
+     * @return false if the file is missing or not a recording. A truncated
+     * tail is ignored.
+     */
+    bool load(const std::string &path);
+
+    const std::vector<Record> &records() const { return m_records; }
+
+    /**
+     * @brief Publish the loaded events to the bus.
+     * @param speed 1.0 keeps the original timing, 2.0 replays twice as fast,
+     * 0 publishes as fast as possible.
+     * @param includeDerived Also publish the derived events (see
+     * RecordedEventId), for a bus without the services that produce them.
+     * @return The number of events published, unknown types are skipped.
+     */
+    size_t replay(EventBus &bus, double speed = 1.0,
+                  bool includeDerived = false);
+
+private:
+    std::vector<Record> m_records;
+}; // class EventReplayer
+
+#endif // EVENTRECORDER_H
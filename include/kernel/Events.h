@@ -11,8 +11,10 @@
 
 #include <cstdint>
 #include <functional>
+#include <kernel/BufferPool.h>
 #include <kernel/WeatherInfo.h>
 #include <kernel/entities/Todo.h>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -24,6 +26,14 @@ struct SystemEvents
         uint64_t time;
         std::string message;
     };
+
+    // 配置变更事件，Configuration::set 与 loadFromFile 之后异步发出
+    // 各服务据此重新读取自己关心的配置项
+    struct ConfigurationChangedEvent
+    {
+        uint64_t time;
+        std::string key; // 发生变化的配置路径前缀，如 "/audio"，为空表示全部
+    };
 };
 
 struct AudioEvents
@@ -31,10 +41,11 @@ struct AudioEvents
     // 检查是否是唤醒词的事件，由 audio service 发出，被 ai service 接收
     // 场景为：音频服务检测到活动语音，将活动语音数据传递给AI服务，由AI服务进行
     // 唤醒词检测
+    // audioData 通常借自音频服务的缓冲区池，事件销毁后自动归还
     struct CheckIsWakewordEvent
     {
         uint64_t time;
-        std::vector<int16_t> audioData;
+        PooledBuffer<int16_t> audioData;
     };
 
     // 语音内容录制结束事件，由 audio service 发出，被 ai service 和 GUI
@@ -44,7 +55,7 @@ struct AudioEvents
     struct AudioContentRecordingDoneEvent
     {
         uint64_t time;
-        std::vector<int16_t> audioData;
+        PooledBuffer<int16_t> audioData;
     };
 
     // 音频片段事件，由 audio service 发出，被 ai service 接收，用来进行语音检测
@@ -145,37 +156,39 @@ struct TodoEvents
         Todo item; // Todo 对象
     };
 
-    struct GetTodoEvent
+    // 以下为查询请求，通过 EventBus::request() 发出，由 todo service 应答，
+    // 结果为空时同样会应答
+    struct GetTodoRequest
     {
+        using Response = std::optional<Todo>; // 未找到时为空
+
         uint64_t time;
         std::string title; // 待办项标题
-        std::function<void(const Todo &)>
-            receiver; // 接收函数，用于处理获取到的Todo对象
     };
 
-    struct GetAllTodosEvent
+    struct GetAllTodosRequest
     {
+        using Response = std::vector<Todo>;
+
         uint64_t time;
-        std::function<void(const std::vector<Todo> &)>
-            receiver; // 接收函数，用于处理获取到的所有Todo对象
     };
 
-    struct GetTodosByEvent
+    struct GetTodosByRequest
     {
+        using Response = std::vector<Todo>;
+
         uint64_t time;
         std::string sql;                          // sql语句
         std::function<bool(const Todo &)> filter; // 过滤函数
-        std::function<void(const std::vector<Todo> &)>
-            receiver; // 接收函数，用于处理获取到的所有Todo对象
     };
 
-    struct OrderTodosByEvent
+    struct OrderTodosByRequest
     {
+        using Response = std::vector<Todo>;
+
         uint64_t time;
         std::string sql;                                         // sql语句
         std::function<bool(const Todo &, const Todo &)> compare; // 比较函数
-        std::function<void(const std::vector<Todo> &)>
-            receiver; // 接收函数，用于处理获取到的所有Todo对象
     };
 };
 
@@ -0,0 +1,189 @@
+/*******************************************************************************
+**     FileName: Executor.h
+**    ClassName: Executor
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/29 09:40
+**  Description: 内核共享的工作窃取线程池，供事件总线与各服务提交任务
+*******************************************************************************/
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <kernel/KernelExport.h>
+#include <kernel/MPMCQueue.h>
+
+/**
+ * @brief Dispatch lane of an asynchronous event or task.
+ */
+enum class EventPriority
+{
+    kRealtime,    // 延迟敏感且不阻塞的处理，有预留的工作线程
+    kInteractive, // 默认优先级，界面交互等
+    kBackground,  // 网络请求等耗时任务，不会占满所有工作线程
+};
+
+/**
+ * @brief Kernel-wide work-stealing thread pool.
+ *
+ * One reserved worker only runs realtime tasks; the general workers run all
+ * lanes in priority order. Interactive tasks submitted from a general worker
+ * (for example events published by an event handler) go to that worker's
+ * own bounded deque, which the owner drains in submission order and idle
+ * workers steal from; once it is full they fall back to the shared lane.
+ * Other submissions go to shared bounded lanes.
+ *
+ * The threads are started on the first submission. The number of general
+ * workers comes from /app/executor/workers (0 or missing: one per hardware
+ * thread, at least two) unless setWorkerCount() was called before.
+ */
+class KERNEL_API Executor
+{
+    Executor();
+    ~Executor();
+
+public:
+    static Executor &getInstance();
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief Set the number of general workers. Only effective before the
+     * executor has started.
+     * @return false if the executor is already running.
+     */
+    bool setWorkerCount(uint32_t count);
+
+    /**
+     * @brief Number of general workers, 0 until the executor has started.
+     */
+    uint32_t workerCount() const;
+
+    /**
+     * @brief Run a task on the pool. When the lane is full, other threads
+     * wait for room, but a worker cannot wait on its own pool, so the task
+     * is rejected instead of being run inline.
+     * @return false if the task was rejected or submitted after stop(); the
+     * task is discarded without running.
+     */
+    bool submit(std::function<void()> task,
+                EventPriority priority = EventPriority::kInteractive);
+
+    /**
+     * @brief Submit a task once the delay has elapsed. All timers share one
+     * thread that only waits and submits, the task itself runs on the pool.
+     * @return The timer id, used to cancel it.
+     */
+    uint64_t schedule(std::chrono::milliseconds delay,
+                      std::function<void()> task,
+                      EventPriority priority = EventPriority::kInteractive);
+
+    /**
+     * @brief Cancel a timer that has not fired yet.
+     * @return false if the timer already fired or does not exist.
+     */
+    bool cancel(uint64_t timerId);
+
+    /**
+     * @brief Whether the calling thread is one of the pool workers.
+     */
+    bool isWorkerThread() const;
+
+    /**
+     * @brief Stop the timers and the workers. Queued tasks are discarded.
+     */
+    void stop();
+
+private:
+    // 实时线程只处理实时任务，通用线程按优先级处理所有任务
+    enum class WorkerKind
+    {
+        kRealtime,
+        kGeneral,
+    };
+
+    struct ParkingLot
+    {
+        std::mutex mutex;
+        std::condition_variable cond;
+        std::atomic_uint32_t parked{0};
+    };
+
+    // 通用线程的本地队列：所有者与窃取线程都从头部取，保持提交顺序
+    struct LocalQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct Timer
+    {
+        std::chrono::steady_clock::time_point deadline;
+        std::function<void()> task;
+        EventPriority priority;
+    };
+
+    using TaskQueue = MPMCQueue<std::function<void()>>;
+
+    void ensureStarted();
+    void processTask(WorkerKind kind, size_t index);
+    // 先自旋再休眠地等待任务，返回 false 表示线程池已停止
+    bool waitForTask(WorkerKind kind, size_t index,
+                     std::function<void()> &task, bool &isBackground);
+    bool tryPopTask(WorkerKind kind, size_t index,
+                    std::function<void()> &task, bool &isBackground);
+    bool popLocal(size_t index, std::function<void()> &task);
+    bool steal(size_t index, std::function<void()> &task);
+    bool hasRunnableTask(WorkerKind kind) const;
+    // 唤醒一个休眠的线程，没有线程休眠时返回 false
+    bool unpark(ParkingLot &lot);
+    void timerLoop();
+    TaskQueue &lane(EventPriority priority) const
+    {
+        return *m_lanes[static_cast<size_t>(priority)];
+    }
+
+private:
+    static constexpr size_t kQueueCapacity = 4096;
+    static constexpr size_t kLocalQueueCapacity = 256;
+    static constexpr uint32_t kSpinCount = 64;
+    static constexpr uint32_t kRealtimeWorkers = 1;
+    static constexpr uint32_t kMinGeneralWorkers = 2;
+    static constexpr size_t kLaneCount = 3;
+
+    std::mutex m_mutexForStart;
+    std::atomic_bool m_started{false};
+    uint32_t m_requestedWorkers = 0;
+    std::atomic_uint32_t m_workerCount{0};
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<LocalQueue>> m_localQueues;
+    // 所有本地队列中的任务总数，休眠判断时无需逐个加锁检查
+    std::atomic_size_t m_localTaskCount{0};
+    std::array<std::unique_ptr<TaskQueue>, kLaneCount> m_lanes;
+    uint32_t m_maxBackgroundWorkers = 1;
+    std::atomic_uint32_t m_runningBackground{0};
+    ParkingLot m_realtimeLot;
+    ParkingLot m_generalLot;
+    std::atomic_bool m_stop{false};
+
+    std::thread m_timerThread;
+    std::mutex m_mutexForTimers;
+    std::condition_variable m_condForTimers;
+    std::map<uint64_t, Timer> m_timers;
+    uint64_t m_nextTimerId = 1;
+}; // class Executor
+
+#endif // EXECUTOR_H
@@ -0,0 +1,155 @@
+/*******************************************************************************
+**     FileName: MPMCQueue.h
+**    ClassName: MPMCQueue
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/18 10:02
+**  Description: 有界无锁多生产者/多消费者队列
+*******************************************************************************/
+
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer queue.
+ *
+ * Each cell carries a sequence number that tells producers and consumers
+ * whether the cell is free or holds a value for the current lap, so push and
+ * pop only contend on a single CAS of the head/tail position. The capacity is
+ * rounded up to a power of two.
+ *
+ * @tparam T The element type. Must be default constructible and movable.
+ */
+template <typename T> class MPMCQueue
+{
+public:
+    explicit MPMCQueue(size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity)), m_mask(m_capacity - 1),
+          m_cells(new Cell[m_capacity])
+    {
+        for (size_t i = 0; i < m_capacity; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue &) = delete;
+    MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+    /**
+     * @brief Try to push a value into the queue.
+     * @return false if the queue is full, the value is left untouched.
+     */
+    bool tryPush(T &&value)
+    {
+        Cell *cell = nullptr;
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Try to pop a value from the queue.
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T &value)
+    {
+        Cell *cell = nullptr;
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->data = T();
+        cell->sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued elements, only meaningful as a hint.
+     */
+    size_t sizeApprox() const
+    {
+        size_t enqueuePos = m_enqueuePos.load(std::memory_order_relaxed);
+        size_t dequeuePos = m_dequeuePos.load(std::memory_order_relaxed);
+        return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    }
+
+    bool empty() const { return sizeApprox() == 0; }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    static constexpr size_t kCacheLineSize = 64;
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(kCacheLineSize) std::atomic<size_t> m_enqueuePos{0};
+    alignas(kCacheLineSize) std::atomic<size_t> m_dequeuePos{0};
+}; // class MPMCQueue
+
+#endif // MPMCQUEUE_H
@@ -0,0 +1,141 @@
+/*******************************************************************************
+**     FileName: SPSCRingBuffer.h
+**    ClassName: SPSCRingBuffer
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/30 10:15
+**  Description: 有界无锁单生产者/单消费者环形缓冲区
+*******************************************************************************/
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Bounded wait-free single-producer/single-consumer ring buffer of
+ * trivially copyable elements.
+ *
+ * Made for handing samples from a realtime thread to a worker: the storage
+ * is allocated once by resize(), and write/read are a bounded memcpy plus one
+ * release store, they never lock, allocate or loop. Exactly one thread may
+ * write and one thread may read at a time. The capacity is rounded up to a
+ * power of two.
+ *
+ * @tparam T The element type. Must be trivially copyable.
+ */
+template <typename T> class SPSCRingBuffer
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SPSCRingBuffer only holds trivially copyable elements");
+
+public:
+    SPSCRingBuffer() = default;
+    explicit SPSCRingBuffer(size_t capacity) { resize(capacity); }
+
+    SPSCRingBuffer(const SPSCRingBuffer &) = delete;
+    SPSCRingBuffer &operator=(const SPSCRingBuffer &) = delete;
+
+    /**
+     * @brief Reallocate the storage and drop the content. Must not run
+     * concurrently with any other member function.
+     */
+    void resize(size_t capacity)
+    {
+        m_capacity = roundUpToPowerOfTwo(capacity);
+        m_mask = m_capacity - 1;
+        m_buffer.reset(new T[m_capacity]);
+        clear();
+    }
+
+    /**
+     * @brief Drop the content. Must not run concurrently with a write or a
+     * read.
+     */
+    void clear()
+    {
+        m_writePos.store(0, std::memory_order_relaxed);
+        m_readPos.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Producer side: append count elements, all or nothing.
+     * @return false if there is not enough free space, nothing is written.
+     */
+    bool tryWrite(const T *data, size_t count)
+    {
+        size_t writePos = m_writePos.load(std::memory_order_relaxed);
+        size_t readPos = m_readPos.load(std::memory_order_acquire);
+        if (m_capacity - (writePos - readPos) < count)
+        {
+            return false;
+        }
+        // 写入位置可能跨过缓冲区末尾，分两段拷贝
+        size_t offset = writePos & m_mask;
+        size_t firstPart = std::min(count, m_capacity - offset);
+        std::memcpy(&m_buffer[offset], data, firstPart * sizeof(T));
+        std::memcpy(&m_buffer[0], data + firstPart,
+                    (count - firstPart) * sizeof(T));
+        m_writePos.store(writePos + count, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side: take count elements, all or nothing.
+     * @return false if fewer than count elements are available.
+     */
+    bool tryRead(T *data, size_t count)
+    {
+        size_t readPos = m_readPos.load(std::memory_order_relaxed);
+        size_t writePos = m_writePos.load(std::memory_order_acquire);
+        if (writePos - readPos < count)
+        {
+            return false;
+        }
+        size_t offset = readPos & m_mask;
+        size_t firstPart = std::min(count, m_capacity - offset);
+        std::memcpy(data, &m_buffer[offset], firstPart * sizeof(T));
+        std::memcpy(data + firstPart, &m_buffer[0],
+                    (count - firstPart) * sizeof(T));
+        m_readPos.store(readPos + count, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Number of elements ready to read. Exact for the consumer, a
+     * lower bound for other threads.
+     */
+    size_t readAvailable() const
+    {
+        return m_writePos.load(std::memory_order_acquire) -
+               m_readPos.load(std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = 2;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr size_t kCacheLineSize = 64;
+
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    std::unique_ptr<T[]> m_buffer;
+    // 读写位置单调递增，取模后才是下标，差值即为已写入的元素数
+    alignas(kCacheLineSize) std::atomic<size_t> m_writePos{0};
+    alignas(kCacheLineSize) std::atomic<size_t> m_readPos{0};
+}; // class SPSCRingBuffer
+
+#endif // SPSCRINGBUFFER_H
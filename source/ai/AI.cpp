@@ -223,12 +223,23 @@ bool AI::initialize()
         m_data->intentManager->initialize();
         m_data->roleManager->initialize();
 
+        // 唤醒词检查和语音识别都会同步发起网络请求，走默认的交互通道；
+        // 实时通道只有一个预留线程，只留给不阻塞的处理。
+        // AI 服务处理不过来时，只丢弃积压在最前面、已明显过时的语音片段，
+        // 避免堆积大量音频数据；排队中的几个唤醒词候选都会被检查
         auto func = std::bind(&AI::Data::checkIsWakeWord, m_data.get(), std::placeholders::_1);
         m_data->checkWakeWordSubscription =
-            EventBus::getInstance().on<AudioEvents::CheckIsWakewordEvent>(func);
+            EventBus::getInstance().on<AudioEvents::CheckIsWakewordEvent>(
+                func, SubscriptionOptions()
+                          .setPriority(EventPriority::kInteractive)
+                          .setQueueLimit(3, OverflowPolicy::kDropOldest));
         m_data->audioContentRecordingDoneSubscription =
-            EventBus::getInstance().on<AudioEvents::AudioContentRecordingDoneEvent>(std::bind(
-                &AI::Data::onAudioContentRecordingDone, m_data.get(), std::placeholders::_1));
+            EventBus::getInstance().on<AudioEvents::AudioContentRecordingDoneEvent>(
+                std::bind(&AI::Data::onAudioContentRecordingDone, m_data.get(),
+                          std::placeholders::_1),
+                SubscriptionOptions()
+                    .setPriority(EventPriority::kInteractive)
+                    .setQueueLimit(2, OverflowPolicy::kDropOldest));
 
         return true;
     }
@@ -0,0 +1,243 @@
+#include <ai/HttpClientPool.h>
+
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <httplib.h>
+
+#include <kernel/Configuration.h>
+#include <kernel/Logger.h>
+
+namespace ai {
+
+struct HttpClientPool::Connection::Entry
+{
+    std::unique_ptr<httplib::Client> client;
+    std::string baseUrl;
+    std::chrono::steady_clock::time_point lastUsed;
+    uint32_t requests = 0;
+};
+
+// ============== HttpClientPoolStats ==============
+
+double HttpClientPoolStats::connectOverheadMs() const
+{
+    if (newConnectionRequests.count == 0 || reusedConnectionRequests.count == 0)
+    {
+        return 0.0;
+    }
+    double overhead = newConnectionRequests.meanMicroseconds() -
+                      reusedConnectionRequests.meanMicroseconds();
+    return std::max(overhead, 0.0) / 1000.0;
+}
+
+std::string HttpClientPoolStats::summary() const
+{
+    return fmt::format("{} requests, {:.0f}% on reused connections, {} clients created, "
+                       "{} temporary, {} closed idle, {} dropped after errors, {} retired; "
+                       "mean request {:.1f} ms new / {:.1f} ms reused, connect overhead "
+                       "about {:.1f} ms",
+                       requests, reuseRate() * 100, createdClients, overflowClients, evictedIdle,
+                       discardedFailed, retiredClients,
+                       newConnectionRequests.meanMicroseconds() / 1000.0,
+                       reusedConnectionRequests.meanMicroseconds() / 1000.0,
+                       connectOverheadMs());
+}
+
+// ============== HttpClientPool::Options ==============
+
+HttpClientPool::Options HttpClientPool::Options::load()
+{
+    auto &config = Configuration::getInstance();
+    Options result;
+    result.maxConnections = static_cast<size_t>(
+        std::max(0, std::get<int32_t>(config.get("/ai/http_pool/max_connections", 4))));
+    result.idleTimeout = std::chrono::milliseconds(
+        std::get<int32_t>(config.get("/ai/http_pool/idle_timeout_ms", 30000)));
+    result.connectTimeout = std::chrono::milliseconds(
+        std::get<int32_t>(config.get("/ai/http_pool/connect_timeout_ms", 5000)));
+    result.maxRequestsPerConnection = static_cast<uint32_t>(std::max(
+        0, std::get<int32_t>(config.get("/ai/http_pool/max_requests_per_connection", 1000))));
+    return result;
+}
+
+// ============== HttpClientPool::Connection ==============
+
+HttpClientPool::Connection::Connection(HttpClientPool *pool, std::shared_ptr<Entry> entry,
+                                       bool reused, bool pooled)
+    : m_pool(pool), m_entry(std::move(entry)), m_start(std::chrono::steady_clock::now()),
+      m_reused(reused), m_pooled(pooled)
+{
+}
+
+HttpClientPool::Connection::Connection(Connection &&other) noexcept
+    : m_pool(other.m_pool), m_entry(std::move(other.m_entry)), m_start(other.m_start),
+      m_reused(other.m_reused), m_pooled(other.m_pooled), m_succeeded(other.m_succeeded)
+{
+    other.m_pool = nullptr;
+}
+
+HttpClientPool::Connection::~Connection()
+{
+    if (m_pool && m_entry)
+    {
+        m_pool->release(*this);
+    }
+}
+
+httplib::Client &HttpClientPool::Connection::client() const { return *m_entry->client; }
+
+// ============== HttpClientPool ==============
+
+HttpClientPool::HttpClientPool(Options options) : m_options(options) {}
+
+HttpClientPool::~HttpClientPool() { clear(); }
+
+HttpClientPool::Connection HttpClientPool::acquire(const std::string &baseUrl)
+{
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<Connection::Entry> entry;
+    bool pooled = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (baseUrl != m_baseUrl)
+        {
+            // 地址变化后旧地址的连接不再有用
+            m_evictedIdle.fetch_add(m_idle.size(), std::memory_order_relaxed);
+            m_idle.clear();
+            m_baseUrl = baseUrl;
+        }
+        evictIdleLocked(std::chrono::steady_clock::now());
+        if (!m_idle.empty())
+        {
+            // 取最近归还的客户端，它的连接最可能还没有被服务器关闭
+            entry = std::move(m_idle.back());
+            m_idle.pop_back();
+        }
+        else if (m_inUse >= m_options.maxConnections)
+        {
+            // 不等待其他请求归还客户端，临时建一个连接
+            pooled = false;
+        }
+        if (pooled)
+        {
+            ++m_inUse;
+        }
+    }
+
+    if (!entry)
+    {
+        entry = createEntry(baseUrl);
+        (pooled ? m_createdClients : m_overflowClients).fetch_add(1, std::memory_order_relaxed);
+    }
+    bool reused = entry->client->is_socket_open();
+    if (reused)
+    {
+        m_reusedConnections.fetch_add(1, std::memory_order_relaxed);
+    }
+    return Connection(this, std::move(entry), reused, pooled);
+}
+
+void HttpClientPool::release(Connection &connection)
+{
+    auto now = std::chrono::steady_clock::now();
+    (connection.m_reused ? m_reusedConnectionRequests : m_newConnectionRequests)
+        .record(now - connection.m_start);
+    Logger::logDebug("HttpClientPool: request to {} took {} ms on a {} connection",
+                     connection.m_entry->baseUrl,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(now -
+                                                                           connection.m_start)
+                         .count(),
+                     connection.m_reused ? "reused" : "new");
+
+    std::shared_ptr<Connection::Entry> entry = std::move(connection.m_entry);
+    entry->lastUsed = now;
+    ++entry->requests;
+    if (!connection.m_pooled)
+    {
+        entry->client->stop();
+        return;
+    }
+
+    bool keep = true;
+    if (!connection.m_succeeded)
+    {
+        // 传输层失败后连接状态不明，换一个新客户端
+        m_discardedFailed.fetch_add(1, std::memory_order_relaxed);
+        keep = false;
+    }
+    else if (m_options.maxRequestsPerConnection > 0 &&
+             entry->requests >= m_options.maxRequestsPerConnection)
+    {
+        m_retiredClients.fetch_add(1, std::memory_order_relaxed);
+        keep = false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    --m_inUse;
+    if (keep && entry->baseUrl == m_baseUrl)
+    {
+        m_idle.push_back(std::move(entry));
+    }
+    else
+    {
+        entry->client->stop();
+    }
+}
+
+void HttpClientPool::evictIdleLocked(std::chrono::steady_clock::time_point now)
+{
+    if (m_options.idleTimeout.count() <= 0)
+    {
+        return;
+    }
+    auto expired = std::remove_if(m_idle.begin(), m_idle.end(),
+                                  [&](const std::shared_ptr<Connection::Entry> &entry)
+                                  { return now - entry->lastUsed >= m_options.idleTimeout; });
+    size_t evicted = static_cast<size_t>(m_idle.end() - expired);
+    if (evicted > 0)
+    {
+        m_idle.erase(expired, m_idle.end());
+        m_evictedIdle.fetch_add(evicted, std::memory_order_relaxed);
+    }
+}
+
+std::shared_ptr<HttpClientPool::Connection::Entry>
+    HttpClientPool::createEntry(const std::string &baseUrl)
+{
+    auto entry = std::make_shared<Connection::Entry>();
+    entry->baseUrl = baseUrl;
+    entry->client = std::make_unique<httplib::Client>(baseUrl);
+    entry->client->set_keep_alive(true);
+    entry->client->set_connection_timeout(m_options.connectTimeout);
+    entry->client->set_error_logger(
+        [baseUrl](const httplib::Error &err, const httplib::Request *req)
+        {
+            Logger::logError("HttpClientPool: request to {}{} failed: {}", baseUrl,
+                             req ? req->path : std::string(), httplib::to_string(err));
+        });
+    return entry;
+}
+
+void HttpClientPool::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.clear();
+}
+
+HttpClientPoolStats HttpClientPool::stats() const
+{
+    HttpClientPoolStats result;
+    result.requests = m_requests.load(std::memory_order_relaxed);
+    result.reusedConnections = m_reusedConnections.load(std::memory_order_relaxed);
+    result.createdClients = m_createdClients.load(std::memory_order_relaxed);
+    result.overflowClients = m_overflowClients.load(std::memory_order_relaxed);
+    result.evictedIdle = m_evictedIdle.load(std::memory_order_relaxed);
+    result.discardedFailed = m_discardedFailed.load(std::memory_order_relaxed);
+    result.retiredClients = m_retiredClients.load(std::memory_order_relaxed);
+    result.newConnectionRequests = m_newConnectionRequests.snapshot();
+    result.reusedConnectionRequests = m_reusedConnectionRequests.snapshot();
+    return result;
+}
+
+} // namespace ai
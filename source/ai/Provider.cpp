@@ -1,12 +1,23 @@
 #include "ai/Model.h"
 #include <ai/Provider.h>
+#include <kernel/Logger.h>
 #include <vector>
 
 namespace ai {
 
-Provider::Provider() : m_apiKey(""), m_baseUrl("") {}
+Provider::Provider()
+    : m_apiKey(""), m_baseUrl(""), m_httpClientPool(std::make_shared<HttpClientPool>())
+{
+}
 
-Provider::~Provider() {}
+Provider::~Provider()
+{
+    auto stats = m_httpClientPool->stats();
+    if (stats.requests > 0)
+    {
+        Logger::logInfo("Provider {} HTTP connections: {}", m_name, stats.summary());
+    }
+}
 
 std::string Provider::getName() const { return m_name; }
 
@@ -70,4 +81,6 @@ Model::Ptr Provider::createModel(const std::string &modelName) const { return nu
 
 bool Provider::serializable() const { return false; }
 
+HttpClientPool &Provider::httpClientPool() const { return *m_httpClientPool; }
+
 } // namespace ai
@@ -60,5 +60,7 @@ int main(int argc, char *argv[])
     styleFile.close();
     MainWindow w;
     w.show();
-    return a.exec();
+    int ret = a.exec();
+    ServiceManager::getInstance().unloadSystemServices();
+    return ret;
 }
@@ -1,6 +1,7 @@
 #include "SiliconFlowModelExecutors.h"
 #include <ai/Provider.h>
 #include <fmt/chrono.h>
+#include <kernel/AudioTap.h>
 #include <kernel/Configuration.h>
 #include <kernel/EventBus.h>
 #include <kernel/Events.h>
@@ -17,10 +18,6 @@
 
 #include <nlohmann/json.hpp>
 
-#ifdef GA_DEBUG
-#include <fstream>
-#endif
-
 namespace siliconflow {
 
 using json = nlohmann::json;
@@ -37,7 +34,6 @@ Text2Text::~Text2Text() {}
 ai::Model::ModelGenerateResult Text2Text::text2Text(const std::string &prompt) const
 {
     ai::Model::ModelGenerateResult result;
-    httplib::Client client(m_provider.getBaseUrl());
     const std::string path = "/v1/chat/completions";
     httplib::Headers headers;
     headers.insert({"Content-Type", "application/json"});
@@ -60,8 +56,11 @@ ai::Model::ModelGenerateResult Text2Text::text2Text(const std::string &prompt) c
     messageObject["content"] = prompt;
     body["messages"].push_back(messageObject);
 
-    // 发送请求
-    auto res = client.Post(path, headers, body.dump(), "application/json");
+    // 发送请求，复用 Provider 的长连接
+    const std::string payload = body.dump();
+    auto res = m_provider.httpClientPool().send(
+        m_provider.getBaseUrl(), [&](httplib::Client &client)
+        { return client.Post(path, headers, payload, "application/json"); });
     if (res && res->status == 200)
     {
         json response = json::parse(res->body);
@@ -78,6 +77,13 @@ ai::Model::ModelGenerateResult Text2Text::text2Text(const std::string &prompt) c
             result.error = "Failed to parse response from API";
         }
     }
+    else if (!res)
+    {
+        std::string errMsg =
+            fmt::format("Failed to send request to API: {}", httplib::to_string(res.error()));
+        Logger::logError("{}", errMsg);
+        result.error = errMsg;
+    }
     else
     {
         std::string errMsg = fmt::format("Failed to send request to API: {}", res->body);
@@ -126,6 +132,17 @@ ai::Model::ModelGenerateResult Image2Image::image2Image(const std::string &promp
 Speech2Text::Speech2Text(std::shared_ptr<ai::Model> model, const ai::Provider &provider)
     : ai::Model::ModelExecutor(model, provider)
 {
+    // 调试模式下默认保存每段送去识别的语音，由后台线程写文件，不拖慢请求
+#ifdef GA_DEBUG
+    const bool kDefaultTapUploads = true;
+#else
+    const bool kDefaultTapUploads = false;
+#endif
+    auto &config = Configuration::getInstance();
+    if (std::get<bool>(config.get("/audio/tap/uploads", kDefaultTapUploads)))
+    {
+        m_uploadTap = std::make_unique<AudioTap>(AudioTap::Settings::load("upload"));
+    }
 }
 
 Speech2Text::~Speech2Text() {}
@@ -149,104 +166,6 @@ static void sendSpeechRecognitionResultReadyEvent(const std::string &result)
     Logger::logInfo("Speech Recognition Result: {}", result);
 }
 
-#ifdef GA_DEBUG
-static std::string getOutputAudioFilePath()
-{
-    std::string tempAudioDir = "";
-// 日志路径有以下几种：
-// 1. 当前软件运行目录；---- 调试环境下
-// 2. 用户主目录下的 .logs 文件夹；---- 正式环境下
-#ifdef GA_DEBUG
-    auto &config = Configuration::getInstance();
-    auto appDir = std::get<std::string>(
-        config.get("/app/working_dir", Configuration::ConfigValueType(std::string("."))));
-    tempAudioDir = (std::filesystem::path(appDir) / "tempAudios").string();
-#else
-#if defined(_WIN32)
-    tempAudioDir = getenv("USERPROFILE");
-#elif defined(__linux__)
-    tempAudioDir = getenv("HOME");
-#elif defined(__APPLE__)
-    tempAudioDir = getenv("HOME");
-    tempAudioDir += "/Library/Logs";
-#else
-    tempAudioDir = "";
-#endif
-    if (!tempAudioDir.empty())
-    {
-        tempAudioDir += "./tempAudios";
-    }
-#endif
-    auto now = std::chrono::system_clock::now() + std::chrono::hours(8);
-    auto now_truncated = std::chrono::floor<std::chrono::seconds>(now);
-    const std::string dateTime = fmt::format("{:%Y_%m_%d_%H_%M_%S}", now_truncated);
-    const std::string fileName = fmt::format("{}.wav", dateTime);
-    if (!std::filesystem::exists(tempAudioDir))
-    {
-        std::filesystem::create_directories(tempAudioDir);
-    }
-    const std::string filePath = (std::filesystem::path(tempAudioDir) / fileName).string();
-    return filePath;
-}
-
-std::vector<uint8_t> generateWavHeader(int sampleRate, int channels, int bitsPerSample,
-                                       size_t dataSize)
-{
-
-    std::vector<uint8_t> header(44);
-    size_t byteRate = sampleRate * channels * bitsPerSample / 8;
-    size_t blockAlign = channels * bitsPerSample / 8;
-
-    // RIFF chunk
-    header[0] = 'R';
-    header[1] = 'I';
-    header[2] = 'F';
-    header[3] = 'F';
-    uint32_t chunkSize = 36 + dataSize;
-    memcpy(&header[4], &chunkSize, 4);
-    header[8] = 'W';
-    header[9] = 'A';
-    header[10] = 'V';
-    header[11] = 'E';
-
-    // fmt subchunk
-    header[12] = 'f';
-    header[13] = 'm';
-    header[14] = 't';
-    header[15] = ' ';
-    uint32_t fmtSize = 16;
-    memcpy(&header[16], &fmtSize, 4);
-    uint16_t audioFormat = 1; // PCM
-    memcpy(&header[20], &audioFormat, 2);
-    memcpy(&header[22], &channels, 2);
-    memcpy(&header[24], &sampleRate, 4);
-    memcpy(&header[28], &byteRate, 4);
-    memcpy(&header[32], &blockAlign, 2);
-    memcpy(&header[34], &bitsPerSample, 2);
-
-    // data subchunk
-    header[36] = 'd';
-    header[37] = 'a';
-    header[38] = 't';
-    header[39] = 'a';
-    memcpy(&header[40], &dataSize, 4);
-
-    return header;
-}
-
-static void saveAudioData(const std::vector<int16_t> &audio, const std::string &outputAudioPath)
-{
-    std::vector<uint8_t> wavHeader =
-        generateWavHeader(16000, 1, 16, audio.size() * sizeof(int16_t));
-
-    std::ofstream audioFile(outputAudioPath, std::ios::binary);
-    audioFile.write(reinterpret_cast<const char *>(wavHeader.data()), wavHeader.size());
-    audioFile.write(reinterpret_cast<const char *>(audio.data()), audio.size() * sizeof(int16_t));
-    audioFile.close();
-}
-
-#endif
-
 ai::Model::ModelGenerateResult Speech2Text::speech2Text(const std::vector<int16_t> &audio) const
 {
     ai::Model::ModelGenerateResult result;
@@ -260,32 +179,6 @@ ai::Model::ModelGenerateResult Speech2Text::speech2Text(const std::vector<int16_
         return result;
     }
 
-    // 初始化HTTP客户端
-    httplib::Client client(m_provider.getBaseUrl());
-    // client.set_max_timeout(20000); // 设置超时时间（根据需求调整）
-    client.set_error_logger(
-        [&client](const httplib::Error &err, const httplib::Request *req)
-        {
-            switch (err)
-            {
-            case httplib::Error::Connection:
-            {
-                Logger::logError("Connection error: {}", httplib::to_string(err));
-            }
-            break;
-            case httplib::Error::BindIPAddress:
-            {
-                Logger::logError("Bind IP address error: {}", httplib::to_string(err));
-            }
-            break;
-            default:
-            {
-                Logger::logError("Unknown error: {}", httplib::to_string(err));
-            }
-            break;
-            }
-        });
-
     const std::string path = "/v1/audio/transcriptions";
 
     // 设置请求头（仅保留Authorization，删除Content-Type）
@@ -293,21 +186,20 @@ ai::Model::ModelGenerateResult Speech2Text::speech2Text(const std::vector<int16_
     headers.insert({"Authorization", "Bearer " + m_provider.getApiKey()});
     // headers.insert({"Content-Type", "multipart/form-data"});
 
-    // 将int16_t音频数据写入到文件，确定文件是否正常
-    const std::string outputAudioPath = getOutputAudioFilePath();
-    saveAudioData(audio, outputAudioPath);
-
-    std::ifstream inFile(outputAudioPath, std::ios::binary);
-    if (!inFile.is_open())
+    // 直接在内存中拼出 WAV 文件上传，诊断录音交给后台线程
+    const int32_t sampleRate =
+        std::get<int32_t>(Configuration::getInstance().get("/audio/sample_rate", 16000));
+    const uint32_t dataBytes = static_cast<uint32_t>(audio.size() * sizeof(int16_t));
+    std::string bufferStr = AudioTap::wavHeader(sampleRate, 1, 16, dataBytes);
+    bufferStr.append(reinterpret_cast<const char *>(audio.data()), dataBytes);
+    if (m_uploadTap)
     {
-        result.error = "Failed to open audio file for reading";
-        Logger::logError(result.error);
-        sendSpeechRecognitionResultReadyEvent(result.error);
-        return result;
+        // 首次上传时才启动写线程，未使用的语音模型不占用线程
+        std::call_once(m_uploadTapStarted, [this] { m_uploadTap->start(); });
+        m_uploadTap->writeClip(audio);
     }
-    Logger::logInfo("Sending audio file to LLM for recognition: {}", outputAudioPath);
-    std::string bufferStr((std::istreambuf_iterator<char>(inFile)),
-                          std::istreambuf_iterator<char>());
+    Logger::logInfo("Sending {} ms of audio to LLM for recognition",
+                    audio.size() * 1000 / sampleRate);
 
     httplib::UploadFormDataItems items = {
         {
@@ -323,8 +215,10 @@ ai::Model::ModelGenerateResult Speech2Text::speech2Text(const std::vector<int16_
         // 可添加其他参数：如response_format="text"（默认json）
     };
 
-    // 发送POST请求
-    auto res = client.Post(path, headers, items);
+    // 发送POST请求，复用 Provider 的长连接，省去每段语音的 TCP/TLS 握手
+    auto res = m_provider.httpClientPool().send(m_provider.getBaseUrl(),
+                                                [&](httplib::Client &client)
+                                                { return client.Post(path, headers, items); });
 
     // 处理网络错误（无响应）
     if (!res)
@@ -11,6 +11,10 @@
 
 #include <ai/Model.h>
 #include <ai/Provider.h>
+#include <memory>
+#include <mutex>
+
+class AudioTap;
 
 namespace siliconflow {
 
@@ -47,6 +51,10 @@ public:
     ~Speech2Text() override;
 
     ai::Model::ModelGenerateResult speech2Text(const std::vector<int16_t> &audio) const override;
+
+private:
+    std::unique_ptr<AudioTap> m_uploadTap; // 上传语音的诊断录音，未开启时为空
+    mutable std::once_flag m_uploadTapStarted;
 };
 
 class Text2Speech : public ai::Model::ModelExecutor
@@ -2,9 +2,13 @@
 #include "TodoListItem.h"
 #include "kernel/EventBus.h"
 #include "kernel/Events.h"
+#include "kernel/Logger.h"
 
+#include <QCoreApplication>
 #include <QHBoxLayout>
 #include <QListWidget>
+#include <QMetaObject>
+#include <QPointer>
 
 #include <functional>
 
@@ -47,33 +51,63 @@ void TodoList::initUI()
     layout->addWidget(m_data->listWidget);
     setLayout(layout);
 
-    m_data->todoCreatedSubscription = EventBus::getInstance().on<TodoEvents::TodoCreatedEvent>(
-        std::bind(&TodoList::onTodoCreated, this, std::placeholders::_1));
-    m_data->todoDeletedSubscription = EventBus::getInstance().on<TodoEvents::TodoDeletedEvent>(
-        std::bind(&TodoList::onTodoDeleted, this, std::placeholders::_1));
-    m_data->todoUpdatedSubscription = EventBus::getInstance().on<TodoEvents::TodoUpdatedEvent>(
-        std::bind(&TodoList::onTodoUpdated, this, std::placeholders::_1));
-
     connect(this, SIGNAL(todoCreated(const Todo &)), this, SLOT(slotOnTodoCreated(const Todo &)));
     connect(this, SIGNAL(todoDeleted(const std::string &)), this,
             SLOT(slotOnTodoDeleted(const std::string &)));
     connect(this, SIGNAL(todoUpdated(const Todo &)), this, SLOT(slotOnTodoUpdated(const Todo &)));
 
-    TodoEvents::GetTodosByEvent getTodosEvent;
-    getTodosEvent.filter = [](const Todo &todo)
+    TodoEvents::GetTodosByRequest getTodosRequest;
+    getTodosRequest.filter = [](const Todo &todo)
     {
         return todo.status == Todo::Status::kInProgress ||
                todo.status == Todo::Status::kNotStarted || todo.status == Todo::Status::kOverdue;
     };
-    getTodosEvent.sql = "SELECT * FROM todos WHERE status IN (0, 1, 3)";
-    getTodosEvent.receiver = [this](const std::vector<Todo> &todos)
-    {
-        for (const auto &todo : todos)
+    getTodosRequest.sql = "SELECT * FROM todos WHERE status IN (0, 1, 3)";
+    // 不在界面线程中等待查询结果，应答后再切回界面线程添加待办项
+    QPointer<TodoList> self(this);
+    EventBus::getInstance().request<TodoEvents::GetTodosByRequest>(
+        getTodosRequest,
+        [self](std::future<std::vector<Todo>> future)
         {
-            addTodoItem(todo);
-        }
-    };
-    EventBus::getInstance().publish<TodoEvents::GetTodosByEvent>(getTodosEvent);
+            std::vector<Todo> todos;
+            try
+            {
+                todos = future.get();
+            }
+            catch (const std::exception &e)
+            {
+                Logger::logError("TodoList: failed to load todos: {}", e.what());
+            }
+            // 本对象可能在投递前被销毁，因此投递到 qApp，回到界面线程后再检查；
+            // 先添加初始待办再订阅，同一待办不会既在查询结果中又收到创建事件
+            QMetaObject::invokeMethod(
+                qApp,
+                [self, todos = std::move(todos)]()
+                {
+                    if (!self)
+                    {
+                        return;
+                    }
+                    for (const auto &todo : todos)
+                    {
+                        self->addTodoItem(todo);
+                    }
+                    self->subscribeTodoEvents();
+                },
+                Qt::QueuedConnection);
+        });
+}
+
+void TodoList::subscribeTodoEvents()
+{
+    // 每个订阅各自串行：同一种事件按发布顺序处理，创建、删除、更新之间不保证顺序
+    auto options = SubscriptionOptions().setStrand(true);
+    m_data->todoCreatedSubscription = EventBus::getInstance().on<TodoEvents::TodoCreatedEvent>(
+        std::bind(&TodoList::onTodoCreated, this, std::placeholders::_1), options);
+    m_data->todoDeletedSubscription = EventBus::getInstance().on<TodoEvents::TodoDeletedEvent>(
+        std::bind(&TodoList::onTodoDeleted, this, std::placeholders::_1), options);
+    m_data->todoUpdatedSubscription = EventBus::getInstance().on<TodoEvents::TodoUpdatedEvent>(
+        std::bind(&TodoList::onTodoUpdated, this, std::placeholders::_1), options);
 }
 
 void TodoList::addTodoItem(const Todo &todo)
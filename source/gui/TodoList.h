@@ -22,6 +22,8 @@ public:
 
 protected:
     void initUI();
+    // 初始待办加载完成后再订阅待办变更事件
+    void subscribeTodoEvents();
 
 signals:
     void todoCreated(const Todo &todo);
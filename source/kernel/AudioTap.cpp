@@ -0,0 +1,347 @@
+#include <kernel/AudioTap.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+
+#include <kernel/Configuration.h>
+#include <kernel/Logger.h>
+
+namespace
+{
+constexpr size_t kWavHeaderSize = 44;
+// 写线程检查环形缓冲区的间隔，生产者不做任何通知
+constexpr auto kDrainInterval = std::chrono::milliseconds(100);
+
+int32_t readInt(Configuration &config, const std::string &key,
+                int32_t defaultValue)
+{
+    return std::get<int32_t>(config.get(key, defaultValue));
+}
+
+void putLittleEndian(std::string &out, size_t offset, uint32_t value,
+                     size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+} // namespace
+
+AudioTap::Settings AudioTap::Settings::load(const std::string &prefix)
+{
+    auto &config = Configuration::getInstance();
+    Settings result;
+    result.prefix = prefix;
+    result.directory = std::get<std::string>(
+        config.get("/audio/tap/directory", std::string()));
+    if (result.directory.empty())
+    {
+        auto appDir = std::get<std::string>(
+            config.get("/app/working_dir", std::string(".")));
+        result.directory =
+            (std::filesystem::path(appDir) / "tempAudios").string();
+    }
+    result.sampleRate = readInt(config, "/audio/sample_rate", 16000);
+    result.channels = readInt(config, "/audio/channels", 1);
+    result.bufferMs = readInt(config, "/audio/tap/buffer_ms", 2000);
+    result.maxFileMs = readInt(config, "/audio/tap/max_file_ms", 60000);
+    result.maxFileKb = readInt(config, "/audio/tap/max_file_kb", 0);
+    result.maxFiles = readInt(config, "/audio/tap/max_files", 50);
+    result.keepPercent = readInt(config, "/audio/tap/keep_percent", 100);
+    return result;
+}
+
+AudioTap::AudioTap(Settings settings)
+    : m_settings(std::move(settings)), m_random(std::random_device{}())
+{
+    const size_t samplesPerSecond = static_cast<size_t>(
+        std::max(m_settings.sampleRate, 1) * std::max(m_settings.channels, 1));
+    size_t byTime = 0;
+    size_t bySize = 0;
+    if (m_settings.maxFileMs > 0)
+    {
+        byTime = samplesPerSecond * m_settings.maxFileMs / 1000;
+    }
+    if (m_settings.maxFileKb > 0)
+    {
+        size_t bytes = static_cast<size_t>(m_settings.maxFileKb) * 1024;
+        bySize = bytes > kWavHeaderSize
+                     ? (bytes - kWavHeaderSize) / sizeof(int16_t)
+                     : 1;
+    }
+    if (byTime > 0 && bySize > 0)
+    {
+        m_maxSamplesPerFile = std::min(byTime, bySize);
+    }
+    else
+    {
+        m_maxSamplesPerFile = std::max(byTime, bySize);
+    }
+}
+
+AudioTap::~AudioTap() { stop(); }
+
+bool AudioTap::start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(m_settings.directory, error);
+    if (error)
+    {
+        Logger::logError("AudioTap: cannot create {}: {}",
+                         m_settings.directory, error.message());
+        return false;
+    }
+
+    const size_t samplesPerSecond = static_cast<size_t>(
+        std::max(m_settings.sampleRate, 1) * std::max(m_settings.channels, 1));
+    m_ring.resize(samplesPerSecond * std::max(m_settings.bufferMs, 100) /
+                  1000);
+    // 每次取出最多半个环形缓冲区，写线程一轮就能追上
+    m_chunk.resize(m_ring.capacity() / 2);
+    // 随机数发生器不加锁，在写线程启动之前决定本次会话是否录音
+    const bool keepStream = keepSession();
+    m_running = true;
+    m_writerThread = std::thread(&AudioTap::writeLoop, this);
+    // 环形缓冲区准备好之后才允许生产者写入
+    m_recordingStream.store(keepStream, std::memory_order_release);
+    Logger::logInfo("AudioTap: {} recording to {}{}", m_settings.prefix,
+                    m_settings.directory,
+                    m_recordingStream.load() ? "" : ", stream not sampled");
+    return true;
+}
+
+void AudioTap::stop()
+{
+    m_recordingStream.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_cond.notify_all();
+    if (m_writerThread.joinable())
+    {
+        m_writerThread.join();
+    }
+    Logger::logInfo("AudioTap: {} wrote {} files, kept {} of {} clips, "
+                    "dropped {} stream samples",
+                    m_settings.prefix, m_filesWritten.load(),
+                    m_keptClips.load(),
+                    m_keptClips.load() + m_skippedClips.load(),
+                    m_droppedSamples.load());
+}
+
+void AudioTap::write(const int16_t *samples, size_t count)
+{
+    if (!m_recordingStream.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    if (!m_ring.tryWrite(samples, count))
+    {
+        m_droppedSamples.fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void AudioTap::writeClip(std::vector<int16_t> samples)
+{
+    if (samples.empty())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_clips.push_back(std::move(samples));
+    }
+    m_cond.notify_one();
+}
+
+std::string AudioTap::wavHeader(int32_t sampleRate, int32_t channels,
+                                int32_t bitsPerSample, uint32_t dataBytes)
+{
+    const uint32_t blockAlign = channels * bitsPerSample / 8;
+    const uint32_t byteRate = sampleRate * blockAlign;
+    std::string header(kWavHeaderSize, '\0');
+    std::memcpy(&header[0], "RIFF", 4);
+    putLittleEndian(header, 4, 36 + dataBytes, 4);
+    std::memcpy(&header[8], "WAVEfmt ", 8);
+    putLittleEndian(header, 16, 16, 4); // fmt 块大小
+    putLittleEndian(header, 20, 1, 2);  // PCM
+    putLittleEndian(header, 22, channels, 2);
+    putLittleEndian(header, 24, sampleRate, 4);
+    putLittleEndian(header, 28, byteRate, 4);
+    putLittleEndian(header, 32, blockAlign, 2);
+    putLittleEndian(header, 34, bitsPerSample, 2);
+    std::memcpy(&header[36], "data", 4);
+    putLittleEndian(header, 40, dataBytes, 4);
+    return header;
+}
+
+bool AudioTap::keepSession()
+{
+    return m_settings.keepPercent >= 100 ||
+           (m_settings.keepPercent > 0 &&
+            std::uniform_int_distribution<int32_t>(0, 99)(m_random) <
+                m_settings.keepPercent);
+}
+
+void AudioTap::writeLoop()
+{
+    std::deque<std::vector<int16_t>> clips;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cond.wait_for(lock, kDrainInterval,
+                        [this] { return !m_running || !m_clips.empty(); });
+        clips.swap(m_clips);
+        bool running = m_running;
+        lock.unlock();
+
+        // 文件操作都在锁外进行
+        drainStream();
+        for (const auto &clip : clips)
+        {
+            bool keep = keepSession();
+            (keep ? m_keptClips : m_skippedClips).fetch_add(1);
+            if (!keep)
+            {
+                continue;
+            }
+            WavFile file;
+            appendRotating(file, clip.data(), clip.size());
+            closeFile(file);
+        }
+        clips.clear();
+
+        lock.lock();
+        if (!running && m_clips.empty())
+        {
+            break;
+        }
+    }
+    lock.unlock();
+    // 生产者已停止，写完剩余的样本后关闭当前文件
+    drainStream();
+    closeFile(m_streamFile);
+}
+
+void AudioTap::drainStream()
+{
+    size_t available = m_ring.readAvailable();
+    while (available > 0)
+    {
+        size_t count = std::min(available, m_chunk.size());
+        m_ring.tryRead(m_chunk.data(), count);
+        appendRotating(m_streamFile, m_chunk.data(), count);
+        available -= count;
+    }
+}
+
+void AudioTap::appendRotating(WavFile &file, const int16_t *samples,
+                              size_t count)
+{
+    while (count > 0)
+    {
+        if (!file.stream.is_open())
+        {
+            auto now = std::chrono::floor<std::chrono::seconds>(
+                std::chrono::system_clock::now());
+            file.path = (std::filesystem::path(m_settings.directory) /
+                         fmt::format("{}_{:%Y%m%d_%H%M%S}_{:04}.wav",
+                                     m_settings.prefix, now, m_fileIndex++))
+                            .string();
+            file.samples = 0;
+            file.stream.open(file.path, std::ios::binary | std::ios::trunc);
+            if (!file.stream.is_open())
+            {
+                Logger::logError("AudioTap: failed to open {}", file.path);
+                return;
+            }
+            // 先写占位的文件头，关闭时再填入实际长度
+            std::string header = wavHeader(m_settings.sampleRate,
+                                           m_settings.channels, 16, 0);
+            file.stream.write(header.data(), header.size());
+        }
+        size_t room = m_maxSamplesPerFile > 0
+                          ? m_maxSamplesPerFile - file.samples
+                          : count;
+        size_t part = std::min(count, room);
+        file.stream.write(reinterpret_cast<const char *>(samples),
+                          part * sizeof(int16_t));
+        file.samples += part;
+        samples += part;
+        count -= part;
+        if (m_maxSamplesPerFile > 0 && file.samples >= m_maxSamplesPerFile)
+        {
+            closeFile(file);
+        }
+    }
+}
+
+void AudioTap::closeFile(WavFile &file)
+{
+    if (!file.stream.is_open())
+    {
+        return;
+    }
+    std::string header =
+        wavHeader(m_settings.sampleRate, m_settings.channels, 16,
+                  static_cast<uint32_t>(file.samples * sizeof(int16_t)));
+    file.stream.seekp(0);
+    file.stream.write(header.data(), header.size());
+    file.stream.close();
+    file.samples = 0;
+    m_filesWritten.fetch_add(1, std::memory_order_relaxed);
+    removeOldFiles();
+}
+
+void AudioTap::removeOldFiles()
+{
+    if (m_settings.maxFiles <= 0)
+    {
+        return;
+    }
+    // 文件名以时间和序号开头，按名称排序即按写入顺序排序
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    const std::string prefix = m_settings.prefix + "_";
+    for (const auto &entry :
+         std::filesystem::directory_iterator(m_settings.directory, error))
+    {
+        const auto &path = entry.path();
+        if (path.extension() == ".wav" &&
+            path.filename().string().rfind(prefix, 0) == 0)
+        {
+            files.push_back(path);
+        }
+    }
+    if (files.size() <= static_cast<size_t>(m_settings.maxFiles))
+    {
+        return;
+    }
+    std::sort(files.begin(), files.end());
+    size_t excess = files.size() - m_settings.maxFiles;
+    for (size_t i = 0; i < excess; ++i)
+    {
+        std::filesystem::remove(files[i], error);
+    }
+}
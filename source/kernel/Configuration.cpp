@@ -1,7 +1,10 @@
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <kernel/Configuration.h>
+#include <kernel/EventBus.h>
+#include <kernel/Events.h>
 #include <kernel/Logger.h>
 #include <map>
 #include <nlohmann/json.hpp>
@@ -26,6 +29,20 @@ std::vector<std::string> splitKey(const std::string &key)
 
 using json = nlohmann::json;
 
+namespace
+{
+// 通知各服务重新读取配置，没有订阅者时不产生任何开销
+void publishConfigurationChanged(const std::string &key)
+{
+    SystemEvents::ConfigurationChangedEvent event;
+    event.time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::system_clock::now().time_since_epoch())
+                     .count();
+    event.key = key;
+    EventBus::getInstance().publish_async(std::move(event));
+}
+} // namespace
+
 // ========================= Configuration =========================
 
 struct Configuration::Data
@@ -67,6 +84,7 @@ Configuration &Configuration::set(const std::string &key,
         // Use original dot notation for backward compatibility
         std::visit([&](auto &&arg) { m_data->values[key] = arg; }, value);
     }
+    publishConfigurationChanged(key);
     return *this;
 }
 
@@ -280,6 +298,7 @@ bool Configuration::loadFromFile(const std::string &path)
         return false;
     }
     m_data->values = j;
+    publishConfigurationChanged("");
     return true;
 }
 
@@ -1,5 +1,30 @@
 #include <kernel/EventBus.h>
 
+#include <algorithm>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace
+{
+// 将事件类型名还原为可读形式，仅用于日志与指标
+std::string readableTypeName(std::type_index type)
+{
+#ifdef __GNUG__
+    int status = 0;
+    std::unique_ptr<char, void (*)(void *)> demangled(
+        abi::__cxa_demangle(type.name(), nullptr, nullptr, &status),
+        std::free);
+    if (status == 0 && demangled)
+    {
+        return demangled.get();
+    }
+#endif
+    return type.name();
+}
+} // namespace
+
 // ============ Subscription ==============
 
 Subscription::Subscription(std::function<void()> unsubscribeFunc)
@@ -36,7 +61,9 @@ void Subscription::unsubscribe()
 
 // ============== EventBus ==============
 
-EventBus::EventBus() {}
+EventBus::EventBus() : m_executor(Executor::getInstance()) {}
+
+EventBus::~EventBus() { stopMetricsDump(); }
 
 EventBus &EventBus::getInstance()
 {
@@ -44,86 +71,346 @@ EventBus &EventBus::getInstance()
     return instance;
 }
 
+EventBus::IChannel &
+    EventBus::resolveChannel(std::type_index type,
+                             std::unique_ptr<IChannel> (*factory)())
+{
+    std::lock_guard<std::mutex> lock(m_mutexForSubscription);
+    auto &eventChannel = m_channels[type];
+    if (!eventChannel)
+    {
+        eventChannel = factory();
+    }
+    return *eventChannel;
+}
+
 void EventBus::unsubscribe(uint64_t id)
 {
-    std::unique_lock<std::shared_mutex> lock(m_mutexForSubscription);
-    for (auto &it : m_subscriptions)
+    std::lock_guard<std::mutex> lock(m_mutexForSubscription);
+    auto iter = m_subscriptionIndex.find(id);
+    if (iter == m_subscriptionIndex.end())
+    {
+        return;
+    }
+    SubscriptionSlot location = iter->second;
+    m_subscriptionIndex.erase(iter);
+
+    SlotRelocations relocations;
+    location.channel->remove(location.slot, id, relocations);
+    for (const auto &relocation : relocations)
     {
-        auto &vec = it.second;
-        auto subscriber =
-            std::find_if(vec.begin(), vec.end(),
-                         [id](const std::shared_ptr<IEventCallback> &callback)
-                         { return callback->id() == id; });
-        if (subscriber != vec.end())
+        auto relocated = m_subscriptionIndex.find(relocation.first);
+        if (relocated == m_subscriptionIndex.end())
         {
-            vec.erase(subscriber);
+            continue;
         }
-        else
+        if (relocation.second == kInvalidSlot)
         {
-            continue;
+            m_subscriptionIndex.erase(relocated);
         }
-        if (vec.empty())
+        else
         {
-            m_subscriptions.erase(it.first);
+            relocated->second.slot = relocation.second;
         }
-        break;
     }
 }
 
-// ============== workPool ==============
+bool EventBus::flush(std::chrono::milliseconds timeout)
+{
+    if (m_executor.isWorkerThread())
+    {
+        Logger::logError("EventBus: flush called from an event handler");
+        return false;
+    }
+    auto finished = [this]
+    { return m_inFlightTasks.load(std::memory_order_acquire) == 0; };
+    std::unique_lock<std::mutex> lock(m_mutexForFlush);
+    if (timeout == std::chrono::milliseconds::max())
+    {
+        m_condForFlush.wait(lock, finished);
+        return true;
+    }
+    return m_condForFlush.wait_for(lock, timeout, finished);
+}
+
+ShutdownReport EventBus::shutdown(std::chrono::milliseconds deadline)
+{
+    ShutdownReport report;
+    if (m_isShutdown.load())
+    {
+        return report;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t completedBefore = m_completedTasks.load();
+
+    report.drained = flush(deadline);
+    m_isShutdown = true;
+    stopMetricsDump();
+    report.discardedTasks = m_inFlightTasks.load();
+
+    report.completedTasks = m_completedTasks.load() - completedBefore;
+    report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    if (report.drained)
+    {
+        Logger::logInfo("EventBus: shutdown in {} ms, {} tasks drained",
+                        report.elapsed.count(), report.completedTasks);
+    }
+    else
+    {
+        Logger::logWarning("EventBus: shutdown deadline of {} ms exceeded, {} "
+                           "tasks drained, {} tasks discarded",
+                           deadline.count(), report.completedTasks,
+                           report.discardedTasks);
+    }
+    return report;
+}
+
+void EventBus::finishTask()
+{
+    m_completedTasks.fetch_add(1, std::memory_order_relaxed);
+    if (m_inFlightTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForFlush);
+        m_condForFlush.notify_all();
+    }
+}
+
+void EventBus::setMetricsOptions(const MetricsOptions &options)
+{
+    stopMetricsDump();
+    m_slowCallbackMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            options.slowCallbackThreshold)
+            .count();
+    m_metricsEnabled = options.enabled;
+    if (!options.enabled || options.dumpInterval.count() <= 0)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForMetricsDump);
+        m_stopMetricsDump = false;
+    }
+    m_metricsDumpThread = std::thread(
+        [this, interval = options.dumpInterval]()
+        {
+            std::unique_lock<std::mutex> lock(m_mutexForMetricsDump);
+            while (!m_condForMetricsDump.wait_for(
+                lock, interval, [this] { return m_stopMetricsDump; }))
+            {
+                lock.unlock();
+                dumpMetrics();
+                lock.lock();
+            }
+        });
+}
+
+EventBusMetrics EventBus::metrics()
+{
+    EventBusMetrics result;
+    result.enabled = isMetricsEnabled();
+    result.inFlightTasks = m_inFlightTasks.load();
+    std::lock_guard<std::mutex> lock(m_mutexForSubscription);
+    result.eventTypes.reserve(m_channels.size());
+    for (auto &[type, eventChannel] : m_channels)
+    {
+        EventTypeMetrics eventTypeMetrics;
+        eventTypeMetrics.name = readableTypeName(type);
+        eventChannel->collectMetrics(eventTypeMetrics);
+        result.eventTypes.push_back(std::move(eventTypeMetrics));
+    }
+    return result;
+}
+
+void EventBus::dumpMetrics()
+{
+    Logger::logInfo("EventBus metrics: {}", metrics().toJson());
+}
+
+void EventBus::reportSlowCallback(std::type_index type, uint64_t id,
+                                  std::chrono::steady_clock::duration elapsed)
+{
+    Logger::logWarning(
+        "EventBus: slow callback for {} (subscription {}) took {} us",
+        readableTypeName(type), id,
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed)
+            .count());
+}
 
-EventBus::WorkPool::WorkPool(uint32_t numWorkers) : m_stop(false)
+void EventBus::stopMetricsDump()
 {
-    if (numWorkers == 0)
     {
-        numWorkers = 1;
+        std::lock_guard<std::mutex> lock(m_mutexForMetricsDump);
+        m_stopMetricsDump = true;
     }
-    for (uint32_t i = 0; i < numWorkers; ++i)
+    m_condForMetricsDump.notify_all();
+    if (m_metricsDumpThread.joinable())
     {
-        m_workers.emplace_back(std::thread(&WorkPool::processTask, this));
+        m_metricsDumpThread.join();
     }
 }
-EventBus::WorkPool::~WorkPool() { stop(); }
 
-void EventBus::WorkPool::enqueue(std::function<void()> task)
+// ============== pendingQueue ==============
+
+void EventBus::PendingQueue::setLimit(const QueueLimit &limit)
 {
-    std::unique_lock<std::mutex> lock(m_mutexForTaskQueue);
-    m_taskQueue.push(std::move(task));
-    m_condForTaskQueue.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_limit = limit;
+        m_bounded.store(limit.capacity > 0, std::memory_order_release);
+    }
+    m_condForSpace.notify_all();
 }
 
-void EventBus::WorkPool::stop()
+std::shared_ptr<EventBus::PendingQueue::Ticket>
+    EventBus::PendingQueue::admit(std::shared_ptr<const void> event,
+                                  size_t taskCount)
 {
-    m_stop = true;
-    m_condForTaskQueue.notify_all();
-    for (auto &worker : m_workers)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_limit.capacity > 0 && m_limit.policy == OverflowPolicy::kKeepLatest)
     {
-        if (worker.joinable())
+        // 新事件到达后，之前尚未处理的事件都已过时
+        for (const auto &ticket : m_tickets)
+        {
+            evict(ticket);
+            m_stats.coalesced++;
+        }
+        m_tickets.clear();
+    }
+    else if (m_limit.capacity > 0 && m_tickets.size() >= m_limit.capacity)
+    {
+        switch (m_limit.policy)
+        {
+        case OverflowPolicy::kBlock:
+        {
+            // 工作线程等待可能导致线程池无法继续处理事件，直接放行
+            if (Executor::getInstance().isWorkerThread())
+            {
+                break;
+            }
+            m_stats.blocked++;
+            m_condForSpace.wait(lock,
+                                [this]
+                                {
+                                    return m_limit.capacity == 0 ||
+                                           m_tickets.size() < m_limit.capacity;
+                                });
+        }
+        break;
+        case OverflowPolicy::kDropOldest:
         {
-            worker.join();
+            evict(m_tickets.front());
+            m_tickets.pop_front();
+            m_stats.dropped++;
+        }
+        break;
+        case OverflowPolicy::kDropNewest:
+        {
+            m_stats.dropped++;
+            return nullptr;
+        }
+        default:
+            break;
         }
     }
+
+    auto ticket = std::make_shared<Ticket>();
+    ticket->event = std::move(event);
+    ticket->remainingTasks = taskCount;
+    m_tickets.push_back(ticket);
+    return ticket;
 }
 
-void EventBus::WorkPool::processTask()
+std::shared_ptr<const void> EventBus::PendingQueue::claim(Ticket &ticket)
 {
-    while (!m_stop)
+    std::shared_ptr<const void> event;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!ticket.event)
+        {
+            return nullptr;
+        }
+        event = ticket.event;
+        if (--ticket.remainingTasks > 0)
+        {
+            return event;
+        }
+        ticket.event.reset();
+        auto iter = std::find_if(m_tickets.begin(), m_tickets.end(),
+                                 [&ticket](const std::shared_ptr<Ticket> &item)
+                                 { return item.get() == &ticket; });
+        if (iter != m_tickets.end())
+        {
+            m_tickets.erase(iter);
+        }
+    }
+    m_condForSpace.notify_one();
+    return event;
+}
+
+QueueStats EventBus::PendingQueue::stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QueueStats stats = m_stats;
+    stats.pending = m_tickets.size();
+    return stats;
+}
+
+void EventBus::PendingQueue::evict(const std::shared_ptr<Ticket> &ticket)
+{
+    ticket->event.reset();
+    ticket->remainingTasks = 0;
+}
+
+// ============== strand ==============
+
+EventBus::Strand::Strand(Executor &executor, EventPriority priority)
+    : m_executor(executor), m_priority(priority)
+{
+}
+
+void EventBus::Strand::post(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+        if (m_scheduled)
+        {
+            return;
+        }
+        m_scheduled = true;
+    }
+    schedule();
+}
+
+void EventBus::Strand::schedule()
+{
+    auto self = shared_from_this();
+    if (!m_executor.submit([self]() { self->drain(); }, m_priority))
+    {
+        // 工作线程提交时队列已满：改由定时线程提交，它会等待队列腾出空间
+        m_executor.schedule(std::chrono::milliseconds(0),
+                            [self]() { self->drain(); }, m_priority);
+    }
+}
+
+void EventBus::Strand::drain()
+{
+    for (size_t i = 0; i < kMaxBatchSize; ++i)
     {
         std::function<void()> task;
         {
-            std::unique_lock<std::mutex> lock(m_mutexForTaskQueue);
-            m_condForTaskQueue.wait(lock, [this]
-                                    { return m_stop || !m_taskQueue.empty(); });
-            if (m_stop)
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_tasks.empty())
             {
+                m_scheduled = false;
                 return;
             }
-            task = std::move(m_taskQueue.front());
-            m_taskQueue.pop();
-        }
-        if (task)
-        {
-            task();
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
         }
+        task();
     }
+    schedule();
 }
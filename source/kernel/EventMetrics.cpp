@@ -0,0 +1,111 @@
+#include <kernel/EventMetrics.h>
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// ============== HistogramSnapshot ==============
+
+uint64_t HistogramSnapshot::percentileMicroseconds(double percentile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(double(count) * percentile / 100.0);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            // 桶 i 的上界为 2^i 微秒，不超过实际最大值
+            return std::min<uint64_t>(uint64_t(1) << i, maxMicroseconds);
+        }
+    }
+    return maxMicroseconds;
+}
+
+// ============== LatencyHistogram ==============
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration duration)
+{
+    auto micros =
+        std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+    size_t bucket = 0;
+    for (uint64_t rest = value; rest != 0 && bucket + 1 < m_buckets.size();
+         rest >>= 1)
+    {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_totalMicroseconds.fetch_add(value, std::memory_order_relaxed);
+    uint64_t currentMax = m_maxMicroseconds.load(std::memory_order_relaxed);
+    while (value > currentMax &&
+           !m_maxMicroseconds.compare_exchange_weak(
+               currentMax, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot result;
+    for (size_t i = 0; i < m_buckets.size(); ++i)
+    {
+        result.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+        result.count += result.buckets[i];
+    }
+    result.totalMicroseconds =
+        m_totalMicroseconds.load(std::memory_order_relaxed);
+    result.maxMicroseconds = m_maxMicroseconds.load(std::memory_order_relaxed);
+    return result;
+}
+
+// ============== EventBusMetrics ==============
+
+namespace
+{
+json histogramToJson(const HistogramSnapshot &histogram)
+{
+    return {{"count", histogram.count},
+            {"mean_us", histogram.meanMicroseconds()},
+            {"p50_us", histogram.percentileMicroseconds(50)},
+            {"p99_us", histogram.percentileMicroseconds(99)},
+            {"max_us", histogram.maxMicroseconds}};
+}
+} // namespace
+
+std::string EventBusMetrics::toJson() const
+{
+    json root;
+    root["enabled"] = enabled;
+    root["in_flight_tasks"] = inFlightTasks;
+    root["event_types"] = json::array();
+    for (const auto &eventType : eventTypes)
+    {
+        json item;
+        item["name"] = eventType.name;
+        item["published"] = eventType.published;
+        item["pending"] = eventType.pending;
+        item["dropped"] = eventType.dropped;
+        item["coalesced"] = eventType.coalesced;
+        item["queue_delay"] = histogramToJson(eventType.queueDelay);
+        item["execution"] = histogramToJson(eventType.execution);
+        item["subscribers"] = json::array();
+        for (const auto &subscriber : eventType.subscribers)
+        {
+            item["subscribers"].push_back(
+                {{"id", subscriber.id},
+                 {"slow_calls", subscriber.slowCalls},
+                 {"execution", histogramToJson(subscriber.execution)}});
+        }
+        root["event_types"].push_back(std::move(item));
+    }
+    return root.dump();
+}
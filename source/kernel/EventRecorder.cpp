@@ -0,0 +1,238 @@
+#include <kernel/EventRecorder.h>
+
+#include <unordered_map>
+
+#include <kernel/EventCodec.h>
+#include <kernel/Logger.h>
+
+namespace
+{
+constexpr char kMagic[] = "GAEVREC1";
+constexpr size_t kMagicSize = sizeof(kMagic) - 1;
+constexpr size_t kRecordHeaderSize =
+    sizeof(uint16_t) + sizeof(uint64_t) + sizeof(uint32_t);
+
+struct ReplayEntry
+{
+    bool (*publish)(EventBus &, const std::string &);
+    bool derived;
+};
+
+// 类型 id 到“解码并发布”函数的映射
+const std::unordered_map<uint16_t, ReplayEntry> &replayTable()
+{
+    static const std::unordered_map<uint16_t, ReplayEntry> table = []
+    {
+        std::unordered_map<uint16_t, ReplayEntry> result;
+        forEachRecordedEvent(
+            [&result](auto tag)
+            {
+                using EventType = typename decltype(tag)::type;
+                result[RecordedEventId<EventType>::value] = {
+                    [](EventBus &bus, const std::string &payload)
+                    {
+                        EventType event{};
+                        BinaryReader reader(payload.data(), payload.size());
+                        serialize(reader, event);
+                        if (!reader.ok())
+                        {
+                            return false;
+                        }
+                        bus.publish_async(std::move(event));
+                        return true;
+                    },
+                    RecordedEventId<EventType>::derived};
+            });
+        return result;
+    }();
+    return table;
+}
+} // namespace
+
+// ============== EventRecorder ==============
+
+EventRecorder::EventRecorder(EventBus &bus) : m_bus(bus) {}
+
+EventRecorder::~EventRecorder() { stop(); }
+
+bool EventRecorder::start(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running)
+    {
+        return false;
+    }
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open())
+    {
+        Logger::logError("EventRecorder: failed to open {}", path);
+        return false;
+    }
+    m_file.write(kMagic, kMagicSize);
+    m_startTime = std::chrono::steady_clock::now();
+    m_running = true;
+    m_writerThread = std::thread(&EventRecorder::writeLoop, this);
+
+    // 内联订阅：在发布线程中记录发布时刻并完成编码
+    forEachRecordedEvent(
+        [this](auto tag)
+        {
+            using EventType = typename decltype(tag)::type;
+            m_subscriptions.push_back(m_bus.on<EventType>(
+                [this](const EventType &event)
+                {
+                    std::string payload;
+                    BinaryWriter writer(payload);
+                    serialize(writer, const_cast<EventType &>(event));
+                    append(RecordedEventId<EventType>::value,
+                           std::move(payload));
+                },
+                SubscriptionOptions().setInlineDelivery(true)));
+        });
+    Logger::logInfo("EventRecorder: recording events to {}", path);
+    return true;
+}
+
+void EventRecorder::stop()
+{
+    m_subscriptions.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_cond.notify_all();
+    if (m_writerThread.joinable())
+    {
+        m_writerThread.join();
+    }
+    m_file.close();
+    Logger::logInfo("EventRecorder: {} events recorded", m_recordedEvents.load());
+}
+
+void EventRecorder::append(uint16_t typeId, std::string payload)
+{
+    uint64_t timestamp =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_startTime)
+            .count();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running)
+        {
+            return;
+        }
+        m_records.push_back({typeId, timestamp, std::move(payload)});
+    }
+    m_recordedEvents.fetch_add(1, std::memory_order_relaxed);
+    m_cond.notify_one();
+}
+
+void EventRecorder::writeLoop()
+{
+    std::deque<Record> batch;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_cond.wait(lock, [this] { return !m_running || !m_records.empty(); });
+        batch.swap(m_records);
+        bool running = m_running;
+        lock.unlock();
+
+        // 在锁外写文件，发布线程只需短暂持锁入队
+        for (const auto &record : batch)
+        {
+            uint32_t size = static_cast<uint32_t>(record.payload.size());
+            m_file.write(reinterpret_cast<const char *>(&record.typeId),
+                         sizeof(record.typeId));
+            m_file.write(reinterpret_cast<const char *>(&record.timestamp),
+                         sizeof(record.timestamp));
+            m_file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+            m_file.write(record.payload.data(), size);
+        }
+        batch.clear();
+
+        lock.lock();
+        if (!running && m_records.empty())
+        {
+            break;
+        }
+    }
+}
+
+// ============== EventReplayer ==============
+
+bool EventReplayer::load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        Logger::logError("EventReplayer: failed to open {}", path);
+        return false;
+    }
+    std::string magic(kMagicSize, '\0');
+    if (!file.read(magic.data(), kMagicSize) || magic != kMagic)
+    {
+        Logger::logError("EventReplayer: {} is not an event recording", path);
+        return false;
+    }
+    m_records.clear();
+    char header[kRecordHeaderSize];
+    while (file.read(header, kRecordHeaderSize))
+    {
+        Record record;
+        uint32_t size = 0;
+        std::memcpy(&record.typeId, header, sizeof(record.typeId));
+        std::memcpy(&record.timestamp, header + sizeof(record.typeId),
+                    sizeof(record.timestamp));
+        std::memcpy(&size,
+                    header + sizeof(record.typeId) + sizeof(record.timestamp),
+                    sizeof(size));
+        record.payload.resize(size);
+        if (!file.read(record.payload.data(), size))
+        {
+            Logger::logWarning("EventReplayer: ignoring truncated record at "
+                               "the end of {}",
+                               path);
+            break;
+        }
+        m_records.push_back(std::move(record));
+    }
+    return true;
+}
+
+size_t EventReplayer::replay(EventBus &bus, double speed, bool includeDerived)
+{
+    const auto &table = replayTable();
+    auto startTime = std::chrono::steady_clock::now();
+    size_t published = 0;
+    for (const auto &record : m_records)
+    {
+        auto iter = table.find(record.typeId);
+        if (iter == table.end() || (iter->second.derived && !includeDerived))
+        {
+            continue;
+        }
+        if (speed > 0)
+        {
+            std::this_thread::sleep_until(
+                startTime + std::chrono::duration_cast<
+                                std::chrono::steady_clock::duration>(
+                                std::chrono::duration<double, std::nano>(
+                                    record.timestamp / speed)));
+        }
+        if (iter->second.publish(bus, record.payload))
+        {
+            ++published;
+        }
+        else
+        {
+            Logger::logWarning("EventReplayer: failed to decode event type {}",
+                               record.typeId);
+        }
+    }
+    return published;
+}
@@ -0,0 +1,385 @@
+#include <kernel/Executor.h>
+
+#include <algorithm>
+
+#include <kernel/Configuration.h>
+#include <kernel/Logger.h>
+
+namespace
+{
+constexpr size_t kNoLocalQueue = static_cast<size_t>(-1);
+
+// 当前线程所属的线程池，以及通用线程对应的本地队列序号
+thread_local const Executor *t_currentExecutor = nullptr;
+thread_local size_t t_localQueueIndex = kNoLocalQueue;
+} // namespace
+
+Executor::Executor() {}
+
+Executor::~Executor() { stop(); }
+
+Executor &Executor::getInstance()
+{
+    static Executor instance;
+    return instance;
+}
+
+bool Executor::setWorkerCount(uint32_t count)
+{
+    std::lock_guard<std::mutex> lock(m_mutexForStart);
+    if (m_started)
+    {
+        Logger::logWarning("Executor: worker count can only be set before the "
+                           "first task is submitted");
+        return false;
+    }
+    m_requestedWorkers = count;
+    return true;
+}
+
+uint32_t Executor::workerCount() const { return m_workerCount.load(); }
+
+bool Executor::isWorkerThread() const { return t_currentExecutor == this; }
+
+void Executor::ensureStarted()
+{
+    if (m_started.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutexForStart);
+    if (m_started.load(std::memory_order_relaxed) || m_stop)
+    {
+        return;
+    }
+
+    uint32_t numWorkers = m_requestedWorkers;
+    if (numWorkers == 0)
+    {
+        numWorkers = static_cast<uint32_t>(std::max(
+            0, std::get<int32_t>(Configuration::getInstance().get(
+                   "/app/executor/workers", int32_t(0)))));
+    }
+    if (numWorkers == 0)
+    {
+        numWorkers = std::thread::hardware_concurrency();
+    }
+    // 至少保留两个通用线程，保证后台任务运行时仍有线程处理交互任务
+    numWorkers = std::max(numWorkers, kMinGeneralWorkers);
+    m_maxBackgroundWorkers = numWorkers - 1;
+
+    for (auto &queue : m_lanes)
+    {
+        queue = std::make_unique<TaskQueue>(kQueueCapacity);
+    }
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        m_localQueues.push_back(std::make_unique<LocalQueue>());
+    }
+    for (uint32_t i = 0; i < kRealtimeWorkers; ++i)
+    {
+        m_workers.emplace_back(&Executor::processTask, this,
+                               WorkerKind::kRealtime, kNoLocalQueue);
+    }
+    for (uint32_t i = 0; i < numWorkers; ++i)
+    {
+        m_workers.emplace_back(&Executor::processTask, this,
+                               WorkerKind::kGeneral, size_t(i));
+    }
+    m_timerThread = std::thread(&Executor::timerLoop, this);
+    m_workerCount = numWorkers;
+    m_started.store(true, std::memory_order_release);
+    Logger::logInfo("Executor: started {} general and {} realtime workers",
+                    numWorkers, kRealtimeWorkers);
+}
+
+bool Executor::submit(std::function<void()> task, EventPriority priority)
+{
+    ensureStarted();
+    if (m_stop)
+    {
+        return false;
+    }
+
+    // 通用线程提交的交互任务放入自己的本地队列，由本线程按提交顺序执行
+    if (priority == EventPriority::kInteractive && t_currentExecutor == this &&
+        t_localQueueIndex != kNoLocalQueue)
+    {
+        LocalQueue &queue = *m_localQueues[t_localQueueIndex];
+        bool queued = false;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            // 本地队列已满时改投共享队列，避免单个线程积压过多任务
+            if (queue.tasks.size() < kLocalQueueCapacity)
+            {
+                queue.tasks.push_back(std::move(task));
+                queued = true;
+            }
+        }
+        if (queued)
+        {
+            m_localTaskCount.fetch_add(1);
+            // 唤醒一个空闲线程来窃取，本线程忙时任务不会被耽搁
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            unpark(m_generalLot);
+            return true;
+        }
+    }
+
+    auto &queue = lane(priority);
+    while (!queue.tryPush(std::move(task)))
+    {
+        if (m_stop)
+        {
+            return false;
+        }
+        // 队列已满：工作线程不能等待自己所在的线程池，拒绝任务交由调用方处理；
+        // 其他线程让出时间片，等待工作线程腾出空间
+        if (t_currentExecutor == this)
+        {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+
+    // 与 waitForTask 中的屏障配对，保证不会漏掉正在休眠的工作线程
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (priority == EventPriority::kRealtime && unpark(m_realtimeLot))
+    {
+        return true;
+    }
+    unpark(m_generalLot);
+    return true;
+}
+
+uint64_t Executor::schedule(std::chrono::milliseconds delay,
+                            std::function<void()> task,
+                            EventPriority priority)
+{
+    ensureStarted();
+    uint64_t timerId = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForTimers);
+        timerId = m_nextTimerId++;
+        m_timers[timerId] = {std::chrono::steady_clock::now() + delay,
+                             std::move(task), priority};
+    }
+    m_condForTimers.notify_one();
+    return timerId;
+}
+
+bool Executor::cancel(uint64_t timerId)
+{
+    std::lock_guard<std::mutex> lock(m_mutexForTimers);
+    return m_timers.erase(timerId) > 0;
+}
+
+void Executor::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForStart);
+        for (ParkingLot *lot : {&m_realtimeLot, &m_generalLot})
+        {
+            std::lock_guard<std::mutex> lotLock(lot->mutex);
+            m_stop = true;
+        }
+        std::lock_guard<std::mutex> timerLock(m_mutexForTimers);
+        m_timers.clear();
+    }
+    m_realtimeLot.cond.notify_all();
+    m_generalLot.cond.notify_all();
+    m_condForTimers.notify_all();
+    for (auto &worker : m_workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+    if (m_timerThread.joinable())
+    {
+        m_timerThread.join();
+    }
+}
+
+void Executor::processTask(WorkerKind kind, size_t index)
+{
+    t_currentExecutor = this;
+    t_localQueueIndex = index;
+    std::function<void()> task;
+    bool isBackground = false;
+    while (waitForTask(kind, index, task, isBackground))
+    {
+        if (task)
+        {
+            task();
+        }
+        task = nullptr;
+        if (isBackground)
+        {
+            m_runningBackground.fetch_sub(1);
+            isBackground = false;
+            // 后台名额被释放，唤醒因名额不足而休眠的线程
+            if (!lane(EventPriority::kBackground).empty())
+            {
+                unpark(m_generalLot);
+            }
+        }
+    }
+}
+
+bool Executor::waitForTask(WorkerKind kind, size_t index,
+                           std::function<void()> &task, bool &isBackground)
+{
+    ParkingLot &lot =
+        kind == WorkerKind::kRealtime ? m_realtimeLot : m_generalLot;
+    while (!m_stop)
+    {
+        for (uint32_t i = 0; i < kSpinCount; ++i)
+        {
+            if (tryPopTask(kind, index, task, isBackground))
+            {
+                return true;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(lot.mutex);
+        lot.parked.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (tryPopTask(kind, index, task, isBackground))
+        {
+            lot.parked.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        lot.cond.wait(lock,
+                      [this, kind] { return m_stop || hasRunnableTask(kind); });
+        lot.parked.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+bool Executor::tryPopTask(WorkerKind kind, size_t index,
+                          std::function<void()> &task, bool &isBackground)
+{
+    if (lane(EventPriority::kRealtime).tryPop(task))
+    {
+        return true;
+    }
+    if (kind == WorkerKind::kRealtime)
+    {
+        return false;
+    }
+    if (popLocal(index, task) ||
+        lane(EventPriority::kInteractive).tryPop(task) || steal(index, task))
+    {
+        return true;
+    }
+
+    // 先占用后台名额再取任务，保证同时运行的后台任务数不超过上限
+    uint32_t running = m_runningBackground.load();
+    while (running < m_maxBackgroundWorkers)
+    {
+        if (m_runningBackground.compare_exchange_weak(running, running + 1))
+        {
+            if (lane(EventPriority::kBackground).tryPop(task))
+            {
+                isBackground = true;
+                return true;
+            }
+            m_runningBackground.fetch_sub(1);
+            return false;
+        }
+    }
+    return false;
+}
+
+bool Executor::popLocal(size_t index, std::function<void()> &task)
+{
+    LocalQueue &queue = *m_localQueues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    m_localTaskCount.fetch_sub(1);
+    return true;
+}
+
+bool Executor::steal(size_t index, std::function<void()> &task)
+{
+    if (m_localTaskCount.load() == 0)
+    {
+        return false;
+    }
+    size_t count = m_localQueues.size();
+    for (size_t i = 1; i < count; ++i)
+    {
+        LocalQueue &queue = *m_localQueues[(index + i) % count];
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.tasks.empty())
+        {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        m_localTaskCount.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool Executor::hasRunnableTask(WorkerKind kind) const
+{
+    if (!lane(EventPriority::kRealtime).empty())
+    {
+        return true;
+    }
+    if (kind == WorkerKind::kRealtime)
+    {
+        return false;
+    }
+    return !lane(EventPriority::kInteractive).empty() ||
+           m_localTaskCount.load() > 0 ||
+           (!lane(EventPriority::kBackground).empty() &&
+            m_runningBackground.load() < m_maxBackgroundWorkers);
+}
+
+bool Executor::unpark(ParkingLot &lot)
+{
+    if (lot.parked.load(std::memory_order_relaxed) == 0)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(lot.mutex);
+    lot.cond.notify_one();
+    return true;
+}
+
+void Executor::timerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutexForTimers);
+    while (!m_stop)
+    {
+        auto next = std::min_element(
+            m_timers.begin(), m_timers.end(), [](const auto &a, const auto &b)
+            { return a.second.deadline < b.second.deadline; });
+        if (next == m_timers.end())
+        {
+            m_condForTimers.wait(lock);
+            continue;
+        }
+        if (next->second.deadline > std::chrono::steady_clock::now())
+        {
+            m_condForTimers.wait_until(lock, next->second.deadline);
+            continue;
+        }
+        Timer timer = std::move(next->second);
+        m_timers.erase(next);
+        lock.unlock();
+        submit(std::move(timer.task), timer.priority);
+        lock.lock();
+    }
+}
@@ -1,17 +1,22 @@
 #include <kernel/ServiceManager.h>
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <kernel/Configuration.h>
 #include <kernel/DynamicLinker.h>
+#include <kernel/EventBus.h>
+#include <kernel/EventRecorder.h>
+#include <kernel/Executor.h>
 #include <kernel/IService.h>
 #include <kernel/Logger.h>
 
 struct ServiceManager::Data
 {
     std::vector<std::shared_ptr<IService>> loadedServices;
+    std::unique_ptr<EventRecorder> recorder;
 };
 
 ServiceManager::ServiceManager() : m_data(std::make_unique<Data>()) {}
@@ -27,6 +32,26 @@ ServiceManager &ServiceManager::getInstance()
 std::vector<std::shared_ptr<IService>> ServiceManager::loadSystemServices()
 {
     auto &config = Configuration::getInstance();
+    MetricsOptions metricsOptions;
+    metricsOptions.enabled = std::get<bool>(
+        config.get("/app/event_bus/metrics_enabled", false));
+    metricsOptions.slowCallbackThreshold = std::chrono::milliseconds(
+        std::get<int32_t>(config.get("/app/event_bus/slow_callback_ms",
+                                     int32_t(50))));
+    metricsOptions.dumpInterval = std::chrono::milliseconds(std::get<int32_t>(
+        config.get("/app/event_bus/metrics_dump_interval_ms", int32_t(0))));
+    EventBus::getInstance().setMetricsOptions(metricsOptions);
+
+    // 配置了录制路径时录制整个会话的事件，供 event_replay 工具离线回放
+    std::string recordPath = std::get<std::string>(
+        config.get("/app/event_bus/record_path", std::string()));
+    if (!recordPath.empty())
+    {
+        m_data->recorder =
+            std::make_unique<EventRecorder>(EventBus::getInstance());
+        m_data->recorder->start(recordPath);
+    }
+
     auto value =
         config.get("/app/system_services",
                    Configuration::ConfigValueType(std::vector<std::string>()));
@@ -60,6 +85,17 @@ std::vector<std::shared_ptr<IService>> ServiceManager::loadSystemServices()
 
 void ServiceManager::unloadSystemServices()
 {
+    auto &config = Configuration::getInstance();
+    std::chrono::milliseconds timeout(std::get<int32_t>(
+        config.get("/app/shutdown_timeout_ms", int32_t(3000))));
+    EventBus &bus = EventBus::getInstance();
+
+    // 先处理完服务发布的异步事件（例如待写入数据库的待办），再关闭服务
+    if (!bus.flush(timeout))
+    {
+        Logger::logWarning("Pending events were not flushed before shutting "
+                           "down services");
+    }
     for (auto service : m_data->loadedServices)
     {
         if (service->isInitialized() && service->isRunning())
@@ -67,4 +103,12 @@ void ServiceManager::unloadSystemServices()
             service->shutdown();
         }
     }
+    if (m_data->recorder)
+    {
+        m_data->recorder->stop();
+        m_data->recorder.reset();
+    }
+    bus.shutdown(timeout);
+    // 事件总线排空之后再停止共享的 Executor，天气刷新等定时任务随之停止
+    Executor::getInstance().stop();
 }
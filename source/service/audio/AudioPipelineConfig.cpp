@@ -0,0 +1,95 @@
+#include "AudioPipelineConfig.h"
+
+#include "kernel/Configuration.h"
+#include "kernel/Logger.h"
+#include <atomic>
+#include <string>
+
+namespace
+{
+AudioPipelineConfig::Ptr g_current;
+
+int32_t readInt(Configuration &config, const std::string &key,
+                int32_t defaultValue)
+{
+    return std::get<int32_t>(config.get(key, defaultValue));
+}
+} // namespace
+
+AudioPipelineConfig AudioPipelineConfig::load()
+{
+    auto &config = Configuration::getInstance();
+    AudioPipelineConfig result;
+    result.sampleRate = readInt(config, "/audio/sample_rate", 16000);
+    result.sampleWidth = readInt(config, "/audio/sample_width", 2);
+    result.channels = readInt(config, "/audio/channels", 1);
+    result.framesPerBuffer = readInt(config, "/audio/frames_per_buffer", 3200);
+    result.ringBufferMs = readInt(config, "/audio/ring_buffer_ms", 2000);
+    result.preRollMs = readInt(config, "/audio/pre_roll_ms", 300);
+    result.statsLogIntervalMs =
+        readInt(config, "/audio/stats_log_interval_ms", 60000);
+
+    result.vadFrameDurationMs =
+        readInt(config, "/audio/vad_frame_duration_ms", 30);
+    result.vadOnsetMs = readInt(config, "/audio/vad_onset_ms", 60);
+    result.vadHangoverMs = readInt(config, "/audio/vad_hangover_ms", 300);
+    result.vadGateEnabled =
+        std::get<bool>(config.get("/audio/vad_gate/enabled", true));
+    result.vadGateMarginDb = readInt(config, "/audio/vad_gate/margin_db", 6);
+    result.vadGateCeilingDbfs =
+        readInt(config, "/audio/vad_gate/ceiling_dbfs", -45);
+
+#ifdef GA_DEBUG
+    // 调试模式下，等待检测结果默认20秒，唤醒词最长10秒
+    const int32_t kDefaultPendingWaitTime_MS = 20000;
+    const int32_t kDefaultWakeWordMaxTime_MS = 10000;
+#else
+    const int32_t kDefaultPendingWaitTime_MS = 5000;
+    const int32_t kDefaultWakeWordMaxTime_MS = 5000;
+#endif
+    result.pendingWaitTimeMs = readInt(config, "/audio/pending_wait_time_ms",
+                                       kDefaultPendingWaitTime_MS);
+    result.wakeWordMaxTimeMs =
+        readInt(config, "/audio/wake_word_detect/wake_word_max_time_ms",
+                kDefaultWakeWordMaxTime_MS);
+    result.wakeWordInactiveMaxTimeMs =
+        readInt(config, "/audio/wake_word_detect/inactive_audio_max_time_ms",
+                1000);
+    result.contentStartInactiveMaxTimeMs = readInt(
+        config, "/audio/content_recognition/start_inactive_audio_max_time_ms",
+        3000);
+    result.contentStopInactiveMaxTimeMs = readInt(
+        config, "/audio/content_recognition/stop_inactive_audio_max_time_ms",
+        3000);
+    result.contentMaxTimeMs =
+        readInt(config, "/audio/content_recognition/content_max_time_ms", 30000);
+
+    if (result.sampleRate <= 0 || result.channels <= 0 ||
+        result.framesPerBuffer <= 0)
+    {
+        Logger::logWarning("AudioPipelineConfig: invalid stream parameters, "
+                           "using the defaults");
+        AudioPipelineConfig defaults;
+        result.sampleRate = defaults.sampleRate;
+        result.channels = defaults.channels;
+        result.framesPerBuffer = defaults.framesPerBuffer;
+    }
+    return result;
+}
+
+AudioPipelineConfig::Ptr AudioPipelineConfig::current()
+{
+    auto snapshot = std::atomic_load(&g_current);
+    if (!snapshot)
+    {
+        reload();
+        snapshot = std::atomic_load(&g_current);
+    }
+    return snapshot;
+}
+
+void AudioPipelineConfig::reload()
+{
+    std::atomic_store(&g_current, Ptr(std::make_shared<AudioPipelineConfig>(
+                                      AudioPipelineConfig::load())));
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+**     FileName: AudioPipelineConfig.h
+**    ClassName: AudioPipelineConfig
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/31 09:30
+**  Description: 音频链路的类型化配置快照
+*******************************************************************************/
+
+#ifndef AUDIOPIPELINECONFIG_H
+#define AUDIOPIPELINECONFIG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Typed snapshot of the /audio configuration.
+ *
+ * Built once by reload() when the audio service starts, and again whenever
+ * the configuration changes; components take current() when they are
+ * created or reset instead of looking keys up per buffer. A snapshot is
+ * immutable, so readers never lock. Stream parameters (sample rate,
+ * buffer size, VAD frame) only apply when the audio device is opened.
+ */
+struct AudioPipelineConfig
+{
+    using Ptr = std::shared_ptr<const AudioPipelineConfig>;
+
+    int32_t sampleRate = 16000;
+    int32_t sampleWidth = 2; // 单位：字节
+    int32_t channels = 1;
+    int32_t framesPerBuffer = 3200;
+    int32_t ringBufferMs = 2000;
+    int32_t preRollMs = 300; // 语音开始前补回的时长，0 表示关闭
+    int32_t statsLogIntervalMs = 60000; // 采集统计的日志间隔，0 表示不输出
+
+    int32_t vadFrameDurationMs = 30;
+    int32_t vadOnsetMs = 60;
+    int32_t vadHangoverMs = 300;
+
+    // VAD 之前的能量门限，见 EnergyGate
+    bool vadGateEnabled = true;
+    int32_t vadGateMarginDb = 6;
+    int32_t vadGateCeilingDbfs = -45;
+
+    int32_t pendingWaitTimeMs = 5000;
+    int32_t wakeWordMaxTimeMs = 5000;
+    int32_t wakeWordInactiveMaxTimeMs = 1000;
+    int32_t contentStartInactiveMaxTimeMs = 3000;
+    int32_t contentStopInactiveMaxTimeMs = 3000;
+    int32_t contentMaxTimeMs = 30000;
+
+    // 以下为根据采样参数计算的值
+    size_t samplesPerBuffer() const
+    {
+        return static_cast<size_t>(framesPerBuffer) * channels;
+    }
+    int32_t bufferDurationMs() const
+    {
+        return framesPerBuffer * 1000 / sampleRate;
+    }
+    size_t vadFrameLength() const
+    {
+        return static_cast<size_t>(sampleRate) * vadFrameDurationMs / 1000;
+    }
+    size_t samplesForMs(int32_t ms) const
+    {
+        return static_cast<size_t>(sampleRate) * channels * ms / 1000;
+    }
+    /**
+     * @brief Read the /audio keys of the configuration into a new snapshot.
+     */
+    static AudioPipelineConfig load();
+
+    /**
+     * @brief The snapshot in effect, loaded on first use.
+     */
+    static Ptr current();
+
+    /**
+     * @brief Rebuild the snapshot from the configuration.
+     */
+    static void reload();
+}; // struct AudioPipelineConfig
+
+#endif // AUDIOPIPELINECONFIG_H
@@ -1,6 +1,10 @@
+#include "AudioPipelineConfig.h"
 #include "AudioWorker.h"
 #include "PortaudioWrapper.h"
 #include "VADDetector.h"
+#include "kernel/AudioTap.h"
+#include "kernel/EventBus.h"
+#include "kernel/Events.h"
 #include "kernel/IService.h"
 #include "kernel/Logger.h"
 #include <atomic>
@@ -17,7 +21,9 @@ struct AudioService::Data
     std::shared_ptr<PortaudioWrapper> audio{nullptr};
     std::shared_ptr<VADDetector> vadDetector{nullptr};
     std::shared_ptr<AudioWorker> worker{nullptr};
+    std::shared_ptr<AudioTap> captureTap{nullptr}; // 麦克风的诊断录音
     std::atomic_bool running{false};
+    Subscription configChangedSubscription{[]() {}};
 };
 
 AudioService::AudioService() : m_data(new Data) {}
@@ -52,8 +58,19 @@ void setupAudioSettings()
 
 bool AudioService::initialize()
 {
-    // 初始化音频配置
+    // 初始化音频配置，并生成各组件共用的配置快照
     setupAudioSettings();
+    AudioPipelineConfig::reload();
+    m_data->configChangedSubscription =
+        EventBus::getInstance().on<SystemEvents::ConfigurationChangedEvent>(
+            [](const SystemEvents::ConfigurationChangedEvent &event)
+            {
+                // 采样参数在下次打开音频设备时生效，其余参数在各状态重新进入时生效
+                if (event.key.empty() || event.key.rfind("/audio", 0) == 0)
+                {
+                    AudioPipelineConfig::reload();
+                }
+            });
     m_data->audio = std::make_shared<PortaudioWrapper>();
     if (!m_data->audio->initialize())
     {
@@ -68,6 +85,15 @@ bool AudioService::initialize()
         return false;
     }
 
+    // 诊断录音：持续录制麦克风音频，由后台线程写文件，不影响采集
+    if (std::get<bool>(Configuration::getInstance().get("/audio/tap/capture",
+                                                        false)))
+    {
+        m_data->captureTap =
+            std::make_shared<AudioTap>(AudioTap::Settings::load("capture"));
+        m_data->audio->setTap(m_data->captureTap);
+    }
+
     m_data->worker =
         std::make_shared<AudioWorker>(m_data->audio, m_data->vadDetector);
 
@@ -85,6 +111,10 @@ bool AudioService::start()
     // TODO: start the audio recording and vad detecting.
     if (m_data->worker)
     {
+        if (m_data->captureTap)
+        {
+            m_data->captureTap->start();
+        }
         m_data->worker->start();
     }
     else
@@ -100,10 +130,22 @@ void AudioService::shutdown()
 {
     if (m_data->initialized)
     {
+        m_data->configChangedSubscription.unsubscribe();
         if (isRunning())
         {
             m_data->worker->stop();
         }
+        if (m_data->captureTap)
+        {
+            m_data->captureTap->stop();
+        }
+        const EnergyGate &gate = m_data->vadDetector->energyGate();
+        Logger::logInfo("AudioService: energy gate skipped {} of {} frames "
+                        "outside speech, noise floor {:.1f} dBFS",
+                        gate.skippedFrames(), gate.measuredFrames(),
+                        gate.noiseFloorDbfs());
+        Logger::logInfo("AudioService: capture {}",
+                        m_data->audio->stats().summary());
     }
     Logger::logInfo("AudioService shutdown.");
 }
@@ -0,0 +1,65 @@
+#include "AudioSource.h"
+
+#include <algorithm>
+
+void AudioSource::setCallback(Callback::Ptr callback)
+{
+    std::lock_guard<std::mutex> lock(m_mutexForCallback);
+    m_callback = callback;
+    m_deliverPreRoll = callback != nullptr;
+}
+
+bool AudioSource::hasCallback() const
+{
+    std::lock_guard<std::mutex> lock(m_mutexForCallback);
+    return m_callback != nullptr;
+}
+
+void AudioSource::setTap(std::shared_ptr<AudioTap> tap) { m_tap = tap; }
+
+void AudioSource::resizePreRoll(size_t samples)
+{
+    m_preRoll.resize(samples);
+    m_preRollBuffer.reserve(samples);
+}
+
+void AudioSource::clearPreRoll()
+{
+    m_preRoll.clear();
+    m_undeliveredSamples = 0;
+}
+
+void AudioSource::dispatch(const std::vector<int16_t> &buffer, int sampleRate,
+                           int samplesPerBuffer)
+{
+    Callback::Ptr callback = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForCallback);
+        callback = m_callback;
+    }
+    if (callback && m_deliverPreRoll.exchange(false) &&
+        m_undeliveredSamples > 0)
+    {
+        // 新回调先处理没有回调期间的音频，再处理当前缓冲区；
+        // 已交给上一个回调的音频不再重放
+        m_preRollBuffer.clear();
+        m_preRoll.appendTo(m_preRollBuffer, m_undeliveredSamples);
+        callback->onDataReady(m_preRollBuffer, sampleRate, samplesPerBuffer);
+    }
+    if (callback)
+    {
+        callback->onDataReady(buffer, sampleRate, samplesPerBuffer);
+        m_undeliveredSamples = 0;
+    }
+    else
+    {
+        m_undeliveredSamples = std::min(m_undeliveredSamples + buffer.size(),
+                                        m_preRoll.capacity());
+    }
+    m_preRoll.push(buffer.data(), buffer.size());
+    if (m_tap)
+    {
+        // 只拷入环形缓冲区，由录音线程写文件
+        m_tap->write(buffer.data(), buffer.size());
+    }
+}
@@ -0,0 +1,83 @@
+/*******************************************************************************
+**     FileName: AudioSource.h
+**    ClassName: AudioSource
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/02 10:05
+**  Description: 音频来源的抽象接口，麦克风与音频文件共用同一套回调
+*******************************************************************************/
+
+#ifndef AUDIOSOURCE_H
+#define AUDIOSOURCE_H
+
+#include "PreRollBuffer.h"
+#include "kernel/AudioTap.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Where AudioWorker gets its audio from.
+ *
+ * Implementations capture or read fixed-size buffers on their own thread
+ * and hand each one to dispatch(), which forwards it to the installed
+ * callback and keeps the pre-roll history.
+ */
+class AudioSource
+{
+public:
+    /**
+     * @brief Consumer of the captured audio, called on the source's
+     * processing thread. A newly installed callback first receives, as one
+     * buffer, the audio captured while no callback was installed (at most
+     * the last pre_roll_ms), so it is not lost. Audio already delivered to
+     * the previous callback is not replayed.
+     */
+    class Callback
+    {
+    public:
+        using Ptr = std::shared_ptr<Callback>;
+        virtual ~Callback() = default;
+        virtual void onDataReady(const std::vector<int16_t> &data,
+                                 int sampleRate, int samplesPerBuffer) = 0;
+        virtual void reset() = 0;
+    };
+
+    virtual ~AudioSource() = default;
+
+    virtual bool startRecording() = 0;
+    virtual bool stopRecording() = 0;
+    virtual bool isRecording() const = 0;
+
+    // 传入空指针表示暂不处理音频，音频来源继续运行，音频只进入预录缓冲区
+    void setCallback(Callback::Ptr callback);
+    bool hasCallback() const;
+
+    /**
+     * @brief Copy every buffer to a diagnostic recording. Set before the
+     * source starts, nullptr removes it.
+     */
+    void setTap(std::shared_ptr<AudioTap> tap);
+
+protected:
+    // 以下函数只在处理线程中调用，或在处理线程未运行时调用
+    void resizePreRoll(size_t samples);
+    void clearPreRoll();
+    void dispatch(const std::vector<int16_t> &buffer, int sampleRate,
+                  int samplesPerBuffer);
+
+private:
+    mutable std::mutex m_mutexForCallback;
+    Callback::Ptr m_callback;
+    // 预录缓冲区：最近一段音频，新回调安装后先交给它
+    PreRollBuffer m_preRoll;
+    std::vector<int16_t> m_preRollBuffer;
+    std::atomic_bool m_deliverPreRoll{false};
+    // 没有回调期间进入预录缓冲区的样本数，只在处理线程中访问
+    size_t m_undeliveredSamples = 0;
+    std::shared_ptr<AudioTap> m_tap;
+}; // class AudioSource
+
+#endif // AUDIOSOURCE_H
@@ -0,0 +1,34 @@
+#include "AudioState.h"
+
+#include "kernel/Logger.h"
+
+AudioState::AudioState(AudioWorker &worker,
+                       std::shared_ptr<AudioSource> audioSampler)
+    : m_worker(worker), m_audioSampler(audioSampler)
+{
+}
+
+AudioState::~AudioState() {}
+
+void AudioState::onExit() { m_deadline = Clock::time_point::max(); }
+
+AudioState::Clock::time_point AudioState::deadline() const
+{
+    return m_deadline;
+}
+
+void AudioState::onTimeout() { onEnter(); }
+
+void AudioState::listen(const AudioSource::Callback::Ptr &callback)
+{
+    m_deadline = Clock::time_point::max();
+    callback->reset();
+    m_audioSampler->setCallback(callback);
+    if (m_audioSampler->isRecording() || m_audioSampler->startRecording())
+    {
+        return;
+    }
+    Logger::logWarning("AudioState: failed to start recording, retry in {}s",
+                       kRetryInterval.count());
+    m_deadline = Clock::now() + kRetryInterval;
+}
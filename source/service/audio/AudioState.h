@@ -3,25 +3,60 @@
 **    ClassName: AudioState
 **       Author: Geocat & LittleBottle
 **  Create Time: 2025/10/03 16:34
-**  Description:
+**  Description: 音频工作线程状态机的状态基类
 *******************************************************************************/
 
 #ifndef AUDIOSTATE_H
 #define AUDIOSTATE_H
 
+#include "AudioSource.h"
+#include <chrono>
 #include <memory>
 
+class AudioWorker;
+
+/**
+ * @brief A state of the AudioWorker state machine.
+ *
+ * All member functions run on the worker thread. The worker calls onEnter()
+ * on every transition into the state, then sleeps until the next state
+ * change or until deadline(), in which case it calls onTimeout().
+ */
 class AudioState
 {
 public:
     using Ptr = std::shared_ptr<AudioState>;
-    AudioState(Ptr next);
+    using Clock = std::chrono::steady_clock;
+
+    AudioState(AudioWorker &worker,
+               std::shared_ptr<AudioSource> audioSampler);
     virtual ~AudioState();
 
-    virtual void handle() = 0;
+    virtual void onEnter() = 0;
+    virtual void onExit();
+
+    /**
+     * @brief Time at which onTimeout() is due, Clock::time_point::max() when
+     * the state only waits for state changes.
+     */
+    virtual Clock::time_point deadline() const;
+
+    /**
+     * @brief Called once the deadline has passed. Retries onEnter() by
+     * default.
+     */
+    virtual void onTimeout();
 
 protected:
-    Ptr m_next;
+    // 安装音频回调并开始录音，启动失败时稍后重试
+    void listen(const AudioSource::Callback::Ptr &callback);
+
+protected:
+    static constexpr std::chrono::seconds kRetryInterval{1};
+
+    AudioWorker &m_worker;
+    std::shared_ptr<AudioSource> m_audioSampler;
+    Clock::time_point m_deadline = Clock::time_point::max();
 }; // class AudioState
 
 #endif // AUDIOSTATE_H
@@ -1,143 +1,149 @@
 #include "AudioWorker.h"
 
-#include "PortaudioWrapper.h"
+#include "AudioPipelineConfig.h"
+#include "AwaitContentState.h"
+#include "AwaitWakewordState.h"
+#include "PendingState.h"
+#include "PreRollBuffer.h"
 #include "VADDetector.h"
-#include "kernel/Configuration.h"
+#include "kernel/BufferPool.h"
 #include "kernel/EventBus.h"
 #include "kernel/Events.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <cmath>
 #include <cstdint>
-#include <fstream>
 #include <functional>
 #include <kernel/Logger.h>
 #include <memory>
 #include <vector>
 
-class AudioPendingCallback : public PortaudioWrapper::Callback
+namespace
+{
+// AI 服务中录音事件的最大排队数，见 AI.cpp 中唤醒词检查（3）与语音内容（2）的
+// setQueueLimit，修改时两边保持一致
+constexpr size_t kAiQueueLimit = 3;
+// 每种录音预留的缓冲区：排队中的事件各持有一个，另加一个正在被 AI 服务处理、
+// 一个正在录制，稳定运行时不会因缓冲池耗尽而临时分配
+constexpr size_t kUtteranceBuffersPerPool = kAiQueueLimit + 2;
+// 超过最长时长的那一帧，以及 VAD 起始确认时一次性补发的帧
+constexpr int32_t kUtteranceSlackMs = 500;
+
+size_t utteranceCapacity(const AudioPipelineConfig &config, int32_t maxMs)
+{
+    return config.samplesForMs(maxMs + kUtteranceSlackMs);
+}
+} // namespace
+
+class WakeWordDetectCallback : public AudioSource::Callback
 {
 public:
-    AudioPendingCallback(AudioWorker &worker) : m_worker(worker)
+    WakeWordDetectCallback(std::shared_ptr<VADDetector> vadDetector,
+                           AudioWorker &worker)
+        : m_vadStream(vadDetector), m_worker(worker)
     {
-        auto &config = Configuration::getInstance();
-        int32_t pendingWaitTime_MS = std::get<int32_t>(
-            config.get("audio.pending_wait_time_ms", (int32_t)5000));
-        m_maxActiveAudioCount = std::ceil(pendingWaitTime_MS / 200.0);
+        // 容量在 resetState 中按当前配置设置，缓冲区在首次取用时分配
+        m_pool = BufferPool<int16_t>::create(0, kUtteranceBuffersPerPool);
+        resetState();
     }
 
     void onDataReady(const std::vector<int16_t> &data, int sampleRate,
                      int samplesPerBuffer) override
     {
-        // 等待检测结果状态，直接忽略数据
-        // 如果 1 秒后还没收到AI服务的返回信息，切换到等待唤醒词状态
-        if (m_waitedAudioCount++ > m_maxActiveAudioCount)
+        if (m_resetPending.exchange(false))
         {
-            m_worker.setState(AudioWorker::WorkerState::kAwaitWakeword);
-            m_waitedAudioCount = 0;
+            resetState();
         }
-        Logger::logDebug("AudioPendingCallback: onDataReady, waitedAudioCount: "
-                         "{}, maxActiveAudioCount: {}",
-                         m_waitedAudioCount, m_maxActiveAudioCount);
+        m_vadStream.process(data.data(), data.size(),
+                            [this](const VADFrame &frame)
+                            { handleFrame(frame); });
+
+        Logger::logDebug("WakeWordDetectCallback: onDataReady, activeMs: "
+                         "{}, inactiveMs: {}, maxActiveMs: {}, "
+                         "maxInactiveMs: {}",
+                         m_activeMs, m_inactiveMs, m_maxActiveMs,
+                         m_maxInactiveMs);
     }
 
-    void reset() override { m_waitedAudioCount = 0; }
+    // 由工作线程调用，实际的重置推迟到处理线程的下一次回调中进行
+    void reset() override { m_resetPending = true; }
 
 protected:
-    AudioWorker &m_worker;
-    uint32_t m_waitedAudioCount = 0;
-    uint32_t m_maxActiveAudioCount = 0;
-};
-
-class WakeWordDetectCallback : public PortaudioWrapper::Callback
-{
-public:
-    WakeWordDetectCallback(std::shared_ptr<VADDetector> vadDetector,
-                           AudioWorker &worker)
-        : m_vadDetector(vadDetector), m_worker(worker)
+    void resetState()
     {
-        auto &config = Configuration::getInstance();
-        // 唤醒词检测最大时间间隔，默认5秒
-#ifdef GA_DEBUG
-        // 调试模式下，默认10秒
-        const int32_t kDefaultWakeWordMaxTime_MS = 10000;
-#else
-        // 非调试模式下，默认5秒
-        const int32_t kDefaultWakeWordMaxTime_MS = 5000;
-#endif
-        int32_t wakeWordMaxTime_MS = std::get<int32_t>(
-            config.get("/audio/wake_word_detect/wake_word_max_time_ms",
-                       (int32_t)kDefaultWakeWordMaxTime_MS));
-        m_maxActiveAudioCount = std::ceil(wakeWordMaxTime_MS / 200.0);
-        // 唤醒词检测后静音时长间隔，默认1秒
-        int32_t inactiveAudioMaxTime_MS = std::get<int32_t>(
-            config.get("/audio/wake_word_detect/inactive_audio_max_time_ms",
-                       (int32_t)1000));
-
-        m_maxInactiveAudioCount = std::ceil(inactiveAudioMaxTime_MS / 200.0);
+        // 唤醒词检测最长时长，以及检测到声音后的静音时长
+        auto config = AudioPipelineConfig::current();
+        m_maxActiveMs = config->wakeWordMaxTimeMs;
+        m_maxInactiveMs = config->wakeWordInactiveMaxTimeMs;
+        m_vadStream.reset();
+        m_activeMs = 0;
+        m_inactiveMs = 0;
+        m_finished = false;
+        const size_t preRollSamples =
+            config->samplesForMs(std::max(config->preRollMs, 0));
+        if (m_leadIn.capacity() != preRollSamples)
+        {
+            m_leadIn.resize(preRollSamples);
+        }
+        m_leadIn.clear();
+        // 上一段录音已随事件移交，从池中取一个预分配的缓冲区
+        m_pool->setCapacity(
+            utteranceCapacity(*config, m_maxActiveMs + config->preRollMs));
+        m_data = m_pool->acquire();
     }
 
-    void onDataReady(const std::vector<int16_t> &data, int sampleRate,
-                     int samplesPerBuffer) override
+    // 逐帧判断，说话结束后的静音时长按帧累计，而不是按整个缓冲区
+    void handleFrame(const VADFrame &frame)
     {
-        bool isAudioActive = false;
-        if (m_vadDetector)
+        if (m_finished)
         {
-            isAudioActive = m_vadDetector->isActiveAudio(data);
+            return;
         }
-        if (isAudioActive)
+        if (frame.event == VADFrame::Event::kSpeechStart)
         {
-            m_activeAudioCount++;
-            m_data.insert(m_data.end(), data.begin(), data.end());
+            // VAD 确认语音时，把之前的静音帧补在前面，避免唤醒词的首音被截断
+            m_leadIn.appendTo(m_data.vector());
+            m_leadIn.clear();
+        }
+        if (frame.inSpeech)
+        {
+            m_activeMs += m_vadStream.frameDurationMs();
+            m_data.append(frame.samples, frame.count);
         }
         else
         {
-            m_inactiveAudioCount++;
+            m_leadIn.push(frame.samples, frame.count);
         }
-
-        Logger::logDebug(
-            "WakeWordDetectCallback: onDataReady, activeAudioCount: "
-            "{}, inactiveAudioCount: {}, maxActiveAudioCount: {}, "
-            "maxInactiveAudioCount: {}",
-            m_activeAudioCount.load(), m_inactiveAudioCount.load(),
-            m_maxActiveAudioCount, m_maxInactiveAudioCount);
-
-        if (m_activeAudioCount == 0 &&
-            m_inactiveAudioCount >= m_maxInactiveAudioCount)
+        // 静音时长从最后一个有声帧开始计算，包含 VAD 的拖尾帧
+        if (frame.inSpeech && frame.voiced)
         {
-            // 静音时长超过阈值，认为需要重置状态
-            reset();
-            return;
+            m_inactiveMs = 0;
+        }
+        else if (m_activeMs > 0)
+        {
+            m_inactiveMs += m_vadStream.frameDurationMs();
         }
 
-        if (m_activeAudioCount >= m_maxActiveAudioCount ||
-            (m_inactiveAudioCount >= m_maxInactiveAudioCount &&
-             m_activeAudioCount > 0))
+        if (m_activeMs >= m_maxActiveMs ||
+            (m_activeMs > 0 && m_inactiveMs >= m_maxInactiveMs))
         {
             // 两种情况需要发送数据
             // 1. 有声音之后，静音时长超过阈值
             // 2. 持续有声音，但是有声时长超限
             sendValidWakeWordEvent();
-            reset();
+            // 本次录音已经结束，剩余的帧等到重新进入该状态后再处理
+            m_finished = true;
         }
     }
 
-    void reset() override
-    {
-        m_activeAudioCount = 0;
-        m_inactiveAudioCount = 0;
-        m_data.clear();
-    }
-
-protected:
     void sendValidWakeWordEvent()
     {
         AudioEvents::CheckIsWakewordEvent event;
-        event.audioData = m_data;
+        event.audioData = std::move(m_data);
         event.time = std::time(nullptr);
-        // 向ai服务发送事件
+        // 向ai服务发送事件，音频数据直接移交给事件，避免复制
         EventBus::getInstance()
-            .publish_async<AudioEvents::CheckIsWakewordEvent>(event);
+            .publish_async<AudioEvents::CheckIsWakewordEvent>(std::move(event));
         Logger::logDebug("AudioService: WakeWordDetectCallback send event of "
                          "AudioEvents::CheckIsWakewordEvent");
 
@@ -146,201 +152,184 @@ protected:
     }
 
 protected:
-    std::shared_ptr<VADDetector> m_vadDetector;
-    std::vector<int16_t> m_data;
-    std::atomic_int16_t m_activeAudioCount{0};
-    std::atomic_int16_t m_inactiveAudioCount{0};
-    uint32_t m_maxActiveAudioCount{0};
-    uint32_t m_maxInactiveAudioCount{0};
+    VADStream m_vadStream;
+    std::shared_ptr<BufferPool<int16_t>> m_pool;
+    PooledBuffer<int16_t> m_data;
+    // 语音开始前最近的静音帧
+    PreRollBuffer m_leadIn;
+    int32_t m_activeMs{0};
+    int32_t m_inactiveMs{0};
+    int32_t m_maxActiveMs{0};
+    int32_t m_maxInactiveMs{0};
+    bool m_finished{false};
+    std::atomic_bool m_resetPending{false};
     AudioWorker &m_worker;
 };
 
-class ContentRecognitionCallback : public PortaudioWrapper::Callback
+class ContentRecognitionCallback : public AudioSource::Callback
 {
 public:
     ContentRecognitionCallback(std::shared_ptr<VADDetector> vadDetector,
                                AudioWorker &worker)
-        : m_worker(worker), m_vadDetector(vadDetector)
+        : m_worker(worker), m_vadStream(vadDetector)
     {
-        auto &config = Configuration::getInstance();
-        // 内容识别最大静音时长间隔，默认3秒，超过该时间间隔没有活动音频，认为需要重置状态
-        std::string key =
-            "/audio/content_recognition/start_inactive_audio_max_time_ms";
-        int32_t startInactiveAudioMaxTime_MS =
-            std::get<int32_t>(config.get(key, (int32_t)3000));
-        m_maxStartInactiveAudioCount =
-            std::ceil(startInactiveAudioMaxTime_MS / 200.0);
-
-        // 内容识别后静音时长间隔，默认3秒
-        key = "/audio/content_recognition/stop_inactive_audio_max_time_ms";
-        int32_t stopInactiveAudioMaxTime_MS =
-            std::get<int32_t>(config.get(key, (int32_t)3000));
-        m_maxStopInactiveAudioCount =
-            std::ceil(stopInactiveAudioMaxTime_MS / 200.0);
+        // 容量在 resetState 中按当前配置设置，缓冲区在首次取用时分配
+        m_pool = BufferPool<int16_t>::create(0, kUtteranceBuffersPerPool);
+        resetState();
     }
 
     void onDataReady(const std::vector<int16_t> &data, int sampleRate,
                      int samplesPerBuffer) override
     {
+        if (m_resetPending.exchange(false))
+        {
+            resetState();
+        }
         // 检测是否存在静音，如果静音了，那么就将数据发送给AI服务
+        m_vadStream.process(data.data(), data.size(),
+                            [this](const VADFrame &frame)
+                            { handleFrame(frame); });
+        Logger::logDebug("ContentRecognitionCallback: onDataReady, activeMs: "
+                         "{}, inactiveMs: {}, maxStartInactiveMs: {}, "
+                         "maxStopInactiveMs: {}",
+                         m_activeMs, m_inactiveMs, m_maxStartInactiveMs,
+                         m_maxStopInactiveMs);
+    }
+
+    // 由工作线程调用，实际的重置推迟到处理线程的下一次回调中进行
+    void reset() override { m_resetPending = true; }
+
+protected:
+    void resetState()
+    {
+        // 内容识别开始前、说话结束后的最大静音时长
+        auto config = AudioPipelineConfig::current();
+        m_maxStartInactiveMs = config->contentStartInactiveMaxTimeMs;
+        m_maxStopInactiveMs = config->contentStopInactiveMaxTimeMs;
+        m_maxActiveMs = config->contentMaxTimeMs;
+        m_vadStream.reset();
+        m_activeMs = 0;
+        m_inactiveMs = 0;
+        m_finished = false;
+        // 录音最长为：开始前的静音 + 最长有声时长 + 结束时的静音
+        m_pool->setCapacity(utteranceCapacity(
+            *config,
+            m_maxStartInactiveMs + m_maxActiveMs + m_maxStopInactiveMs));
+        m_data = m_pool->acquire();
+    }
 
-        bool isAudioActive = true;
-        if (m_vadDetector)
+    void handleFrame(const VADFrame &frame)
+    {
+        if (m_finished)
+        {
+            return;
+        }
+        m_data.append(frame.samples, frame.count);
+        if (frame.inSpeech)
         {
-            isAudioActive = m_vadDetector->isActiveAudio(data);
+            m_activeMs += m_vadStream.frameDurationMs();
         }
-        m_data.insert(m_data.end(), data.begin(), data.end());
-        if (!isAudioActive)
+        // 静音时长从最后一个有声帧开始计算，包含 VAD 的拖尾帧
+        if (frame.inSpeech && frame.voiced)
         {
-            m_inactiveAudioCount++;
+            m_inactiveMs = 0;
         }
         else
         {
-            m_maxStartInactiveAudioCount = 0;
-            m_inactiveAudioCount = 0;
-            m_activeAudioCount++;
+            m_inactiveMs += m_vadStream.frameDurationMs();
         }
-        Logger::logDebug(
-            "ContentRecognitionCallback: onDataReady, activeAudioCount: "
-            "{}, inactiveAudioCount: {}, maxStartInactiveAudioCount: {}, "
-            "maxStopInactiveAudioCount: {}",
-            m_activeAudioCount.load(), m_inactiveAudioCount.load(),
-            m_maxStartInactiveAudioCount, m_maxStopInactiveAudioCount);
-        if (m_inactiveAudioCount >= m_maxStartInactiveAudioCount &&
-            m_activeAudioCount == 0)
+
+        if (m_activeMs == 0 && m_inactiveMs >= m_maxStartInactiveMs)
         {
             // 静音时长超过阈值并且没有活动音频，认为需要重置状态
             m_worker.setState(AudioWorker::WorkerState::kAwaitWakeword);
             // 并发送AudioEvents::AudioContentRecordingDoneEvent事件
-            {
-                AudioEvents::AudioContentRecordingDoneEvent event;
-                event.audioData = m_data;
-                event.time = std::time(nullptr);
-                // 向ai服务发送事件
-                EventBus::getInstance()
-                    .publish_async<AudioEvents::AudioContentRecordingDoneEvent>(
-                        event);
-            }
-            reset(); // 重置状态
-            Logger::logDebug("ContentRecognitionCallback: reset, "
-                             "inactiveAudioCount: "
-                             "{}",
-                             m_inactiveAudioCount.load());
+            AudioEvents::AudioContentRecordingDoneEvent event;
+            event.audioData = std::move(m_data);
+            event.time = std::time(nullptr);
+            // 向ai服务发送事件
+            EventBus::getInstance()
+                .publish_async<AudioEvents::AudioContentRecordingDoneEvent>(
+                    std::move(event));
+            Logger::logDebug("ContentRecognitionCallback: no speech in {} ms",
+                             m_inactiveMs);
+            m_finished = true;
             return;
         }
-        if (m_activeAudioCount > 0 &&
-            m_inactiveAudioCount >= m_maxStopInactiveAudioCount)
+        if (m_activeMs >= m_maxActiveMs ||
+            (m_activeMs > 0 && m_inactiveMs >= m_maxStopInactiveMs))
         {
-            // 活动音频后静音时间超过阈值，认为需要发送数据
+            // 活动音频后静音时间超过阈值，或有声时长超限，认为需要发送数据
             handleRecordingReady();
-            reset();
+            m_finished = true;
         }
     }
 
-    void reset() override
-    {
-        m_inactiveAudioCount = 0;
-        m_data.clear();
-    }
-
-protected:
     void handleRecordingReady()
     {
         Logger::logDebug("ContentRecognitionCallback: handleRecordingReady, "
-                         "inactiveAudioCount: "
-                         "{}",
-                         m_inactiveAudioCount.load());
+                         "inactiveMs: {}",
+                         m_inactiveMs);
+        const size_t dataSize = m_data.size();
         AudioEvents::AudioContentRecordingDoneEvent event;
-        event.audioData = m_data;
+        event.audioData = std::move(m_data);
         event.time = std::time(nullptr);
         // 向ai服务发送事件
         EventBus::getInstance()
-            .publish_async<AudioEvents::AudioContentRecordingDoneEvent>(event);
+            .publish_async<AudioEvents::AudioContentRecordingDoneEvent>(
+                std::move(event));
         Logger::logDebug(
             "AudioService: ContentRecognitionCallback send event of "
             "AudioEvents::AudioContentRecordingDoneEvent, with data size: {}",
-            m_data.size());
+            dataSize);
 
         m_worker.setState(AudioWorker::WorkerState::kPending);
-        reset();
     }
 
 protected:
-    std::shared_ptr<VADDetector> m_vadDetector;
     AudioWorker &m_worker;
-    std::vector<int16_t> m_data;
-    std::atomic_int32_t m_inactiveAudioCount{0};
-    int32_t m_maxStartInactiveAudioCount{0}; // 起始检测最大静音时长间隔
-    int32_t m_maxStopInactiveAudioCount{0};  // 结束检测最大静音时长间隔
-    std::atomic_int32_t m_activeAudioCount{0};
+    VADStream m_vadStream;
+    std::shared_ptr<BufferPool<int16_t>> m_pool;
+    PooledBuffer<int16_t> m_data;
+    int32_t m_activeMs{0};
+    int32_t m_inactiveMs{0};
+    int32_t m_maxStartInactiveMs{0}; // 起始检测最大静音时长间隔
+    int32_t m_maxStopInactiveMs{0};  // 结束检测最大静音时长间隔
+    int32_t m_maxActiveMs{0};        // 最长有声时长
+    bool m_finished{false};
+    std::atomic_bool m_resetPending{false};
 };
 
-class SaveToFileCallback : public PortaudioWrapper::Callback
-{
-    static uint32_t nameSuffix;
-
-public:
-    void onDataReady(const std::vector<int16_t> &data, int sampleRate,
-                     int samplesPerBuffer) override
-    {
-        // 保存音频数据到文件
-        m_data.insert(m_data.end(), data.begin(), data.end());
-        m_count++;
-        if (m_count >= 100) // 20s
-        {
-            auto header = PortaudioWrapper::generateWavHeader(
-                16000, 1, 16, sizeof(int16_t) * m_data.size());
-            std::string fileName = fmt::format("output_{}.wav", nameSuffix++);
-            std::ofstream file(fileName, std::ios::binary);
-            file.write(reinterpret_cast<const char *>(header.data()),
-                       header.size());
-            file.write(reinterpret_cast<const char *>(m_data.data()),
-                       m_data.size() * sizeof(int16_t));
-            file.close();
-            m_data.clear();
-            m_count = 0;
-
-            Logger::logInfo("Audio data has been written into: {}", fileName);
-        }
-    }
-
-    void reset() override
-    {
-        m_data.clear();
-        m_count = 0;
-    }
-
-protected:
-    std::vector<int16_t> m_data;
-    uint32_t m_count;
-};
-
-uint32_t SaveToFileCallback::nameSuffix = 0;
-
-AudioWorker::AudioWorker(std::shared_ptr<PortaudioWrapper> audioSampler,
+AudioWorker::AudioWorker(std::shared_ptr<AudioSource> audioSampler,
                          std::shared_ptr<VADDetector> vadDetector)
     : m_vadDetector(vadDetector), m_audioSampler(audioSampler),
       m_isRunning(false), m_stop(false), m_validWakeWordSubscription([]() {}),
       m_speechRecognitionResultReadySubscription([]() {}),
       m_state(WorkerState::kAwaitWakeword)
 {
-    m_stateCallbacks[WorkerState::kPending] =
-        std::make_shared<AudioPendingCallback>(*this);
-    m_stateCallbacks[WorkerState::kAwaitWakeword] =
-        std::make_shared<WakeWordDetectCallback>(m_vadDetector, *this);
-    m_stateCallbacks[WorkerState::kAwaitContent] =
-        std::make_shared<ContentRecognitionCallback>(m_vadDetector, *this);
-    m_audioSampler->setCallback(m_stateCallbacks[m_state]);
-
+    m_states[WorkerState::kPending] =
+        std::make_shared<PendingState>(*this, m_audioSampler);
+    m_states[WorkerState::kAwaitWakeword] =
+        std::make_shared<AwaitWakewordState>(
+            *this, m_audioSampler,
+            std::make_shared<WakeWordDetectCallback>(m_vadDetector, *this));
+    m_states[WorkerState::kAwaitContent] = std::make_shared<AwaitContentState>(
+        *this, m_audioSampler,
+        std::make_shared<ContentRecognitionCallback>(m_vadDetector, *this));
+
+    // 状态切换需要按事件发布顺序执行，且属于语音链路的实时事件
+    auto options = SubscriptionOptions()
+                       .setStrand(true)
+                       .setPriority(EventPriority::kRealtime);
     auto func = std::bind(&AudioWorker::handleValidWakeWord, this,
                           std::placeholders::_1);
     m_validWakeWordSubscription =
-        EventBus::getInstance().on<AIEvents::ValidWakeWordEvent>(func);
+        EventBus::getInstance().on<AIEvents::ValidWakeWordEvent>(func, options);
     auto func2 = std::bind(&AudioWorker::handleSpeechRecognitionResultReady,
                            this, std::placeholders::_1);
     m_speechRecognitionResultReadySubscription =
         EventBus::getInstance().on<AIEvents::SpeechRecognitionResultReadyEvent>(
-            func2);
+            func2, options);
 }
 
 AudioWorker::~AudioWorker() { stop(); }
@@ -358,84 +347,73 @@ bool AudioWorker::start()
         return false;
     }
 
-    auto func = [&]()
+    m_isRunning = true;
+    m_workerThread = std::thread(&AudioWorker::run, this);
+    return true;
+}
+
+void AudioWorker::run()
+{
+    AudioState::Ptr current = nullptr;
+    uint64_t currentVersion = 0;
+    std::unique_lock<std::mutex> lock(m_mutexForState);
+    while (!m_stop.load())
     {
-        auto pendingCallback = std::make_shared<AudioPendingCallback>(*this);
-        auto awaitWakeWordCallback =
-            std::make_shared<WakeWordDetectCallback>(m_vadDetector, *this);
-        auto awaitContentCallback =
-            std::make_shared<ContentRecognitionCallback>(m_vadDetector, *this);
-        auto saveToFileCallback = std::make_shared<SaveToFileCallback>();
-        auto pendingStartTime = std::chrono::system_clock::now();
-        while (!m_stop.load())
+        if (!current || currentVersion != m_stateVersion)
         {
-            switch (m_state)
-            {
-            case WorkerState::kPending:
-            {
-                auto now = std::chrono::system_clock::now();
-                if (m_audioSampler->isRecording())
-                {
-                    m_audioSampler->stopRecording();
-                    pendingStartTime = now;
-                }
-#ifdef GA_DEBUG
-                const int maxWaitingSeconds = 20;
-#else
-                const int maxWaitingSeconds = 5;
-#endif
-                if (std::chrono::duration_cast<std::chrono::seconds>(
-                        now - pendingStartTime)
-                        .count() >= maxWaitingSeconds)
-                {
-                    setState(WorkerState::kAwaitWakeword);
-                }
-                else
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                }
-            }
-            case WorkerState::kAwaitWakeword:
-            {
-                m_audioSampler->setCallback(awaitWakeWordCallback);
-            }
-            break;
-            case WorkerState::kAwaitContent:
+            AudioState::Ptr next = m_states[m_state.load()];
+            currentVersion = m_stateVersion;
+            // 进出状态会启停录音，期间不能持锁，否则音频处理线程调用
+            // setState 时会与停止录音互相等待
+            lock.unlock();
+            if (current)
             {
-                m_audioSampler->setCallback(awaitContentCallback);
-            }
-            break;
-            default:
-            {
-                m_audioSampler->setCallback(saveToFileCallback);
-            }
-            break;
+                current->onExit();
             }
+            current = next;
+            current->onEnter();
+            lock.lock();
+            m_enteredVersion = currentVersion;
+            m_condForState.notify_all();
+            continue;
+        }
 
-            if (m_state != WorkerState::kPending)
-            {
-                if (!m_audioSampler->isRecording())
-                {
-                    m_audioSampler->startRecording();
-                }
-            }
+        auto isChanged = [&]
+        { return m_stop.load() || currentVersion != m_stateVersion; };
+        auto deadline = current->deadline();
+        if (deadline == AudioState::Clock::time_point::max())
+        {
+            m_condForState.wait(lock, isChanged);
         }
-        if (m_audioSampler->isRecording())
+        else if (!m_condForState.wait_until(lock, deadline, isChanged))
         {
-            m_audioSampler->stopRecording();
+            lock.unlock();
+            current->onTimeout();
+            lock.lock();
         }
-        m_isRunning = false;
-    };
-    m_workerThread = std::thread(func);
-    m_isRunning = true;
-    return true;
+    }
+    lock.unlock();
+
+    if (current)
+    {
+        current->onExit();
+    }
+    if (m_audioSampler->isRecording())
+    {
+        m_audioSampler->stopRecording();
+    }
+    m_isRunning = false;
 }
 
 void AudioWorker::stop()
 {
     m_validWakeWordSubscription.unsubscribe();
     m_speechRecognitionResultReadySubscription.unsubscribe();
-    m_stop = true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForState);
+        m_stop = true;
+    }
+    m_condForState.notify_all();
     if (m_workerThread.joinable())
     {
         m_workerThread.join();
@@ -486,6 +464,22 @@ void AudioWorker::setState(WorkerState state)
     Logger::logDebug("AudioWorker: current state is {}, setState to {}",
                      getWorkerStateString(m_state.load()),
                      getWorkerStateString(state));
-    m_stateCallbacks[m_state]->reset();
-    m_state.store(state);
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForState);
+        m_state.store(state);
+        ++m_stateVersion;
+    }
+    // 除工作线程外，还可能有线程在 waitUntilSettled 中等待
+    m_condForState.notify_all();
+}
+
+void AudioWorker::waitUntilSettled()
+{
+    std::unique_lock<std::mutex> lock(m_mutexForState);
+    m_condForState.wait(lock,
+                        [this]
+                        {
+                            return m_stop.load() || !m_isRunning.load() ||
+                                   m_enteredVersion == m_stateVersion;
+                        });
 }
@@ -9,19 +9,23 @@
 #ifndef AUDIOWORKER_H
 #define AUDIOWORKER_H
 
-#include "PortaudioWrapper.h"
+#include "AudioState.h"
+#include "AudioSource.h"
 #include "VADDetector.h"
 #include "kernel/EventBus.h"
 #include "kernel/Events.h"
 #include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 
 class AudioWorker
 {
 public:
-    AudioWorker(std::shared_ptr<PortaudioWrapper> audioSampler,
+    AudioWorker(std::shared_ptr<AudioSource> audioSampler,
                 std::shared_ptr<VADDetector> vadDetector);
     ~AudioWorker();
 
@@ -38,9 +42,24 @@ public:
 
     static std::string getWorkerStateString(WorkerState state);
 
+    /**
+     * @brief Request a state transition. Thread-safe and non-blocking, the
+     * worker thread performs the transition. Requesting the current state
+     * enters it again, which resets its audio callback.
+     */
     void setState(WorkerState state);
+    WorkerState state() const { return m_state.load(); }
+
+    /**
+     * @brief Block until the worker thread has entered the most recently
+     * requested state, or has stopped. Lets an offline source keep pace
+     * with the state machine.
+     */
+    void waitUntilSettled();
 
 protected:
+    // 工作线程：阻塞等待状态切换或当前状态的超时，空闲时不占用 CPU
+    void run();
     void handleValidWakeWord(const AIEvents::ValidWakeWordEvent &event);
     void handleSpeechRecognitionResultReady(
         const AIEvents::SpeechRecognitionResultReadyEvent &event);
@@ -48,7 +67,7 @@ protected:
 protected:
     std::atomic_bool m_isRunning;
     std::atomic_bool m_stop;
-    std::shared_ptr<PortaudioWrapper> m_audioSampler;
+    std::shared_ptr<AudioSource> m_audioSampler;
     std::shared_ptr<VADDetector> m_vadDetector;
     std::thread m_workerThread;
 
@@ -57,8 +76,12 @@ protected:
 
     // 当前状态：0 - 等待检测结果状态；1 - 等待唤醒词状态；2 - 等待内容状态；
     std::atomic<WorkerState> m_state;
-    std::map<WorkerState, std::shared_ptr<PortaudioWrapper::Callback>>
-        m_stateCallbacks;
+    std::map<WorkerState, AudioState::Ptr> m_states;
+    // 每次 setState 递增，工作线程据此发现状态切换请求
+    uint64_t m_stateVersion = 0;
+    uint64_t m_enteredVersion = 0; // 工作线程已进入的状态对应的版本
+    std::mutex m_mutexForState;
+    std::condition_variable m_condForState;
 }; // class AudioWorker
 
 #endif // AUDIOWORKER_H
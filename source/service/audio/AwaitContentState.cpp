@@ -0,0 +1,13 @@
+#include "AwaitContentState.h"
+
+AwaitContentState::AwaitContentState(
+    AudioWorker &worker, std::shared_ptr<AudioSource> audioSampler,
+    AudioSource::Callback::Ptr recognitionCallback)
+    : AudioState(worker, audioSampler),
+      m_recognitionCallback(recognitionCallback)
+{
+}
+
+AwaitContentState::~AwaitContentState() {}
+
+void AwaitContentState::onEnter() { listen(m_recognitionCallback); }
@@ -3,7 +3,7 @@
 **    ClassName: AwaitContentState
 **       Author: Geocat & LittleBottle
 **  Create Time: 2025/10/03 16:37
-**  Description:
+**  Description: 等待内容状态：录音并把音频交给内容识别回调
 *******************************************************************************/
 
 #ifndef AWAITCONTENTSTATE_H
@@ -16,12 +16,15 @@ class AwaitContentState : public AudioState
 {
 public:
     using Ptr = std::shared_ptr<AwaitContentState>;
-    AwaitContentState(AudioState::Ptr next);
+    AwaitContentState(AudioWorker &worker,
+                      std::shared_ptr<AudioSource> audioSampler,
+                      AudioSource::Callback::Ptr recognitionCallback);
     ~AwaitContentState();
 
-    void handle() override;
+    void onEnter() override;
 
 protected:
+    AudioSource::Callback::Ptr m_recognitionCallback;
 }; // class AwaitContentState
 
 #endif // AWAITCONTENTSTATE_H
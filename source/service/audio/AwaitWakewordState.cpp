@@ -0,0 +1,12 @@
+#include "AwaitWakewordState.h"
+
+AwaitWakewordState::AwaitWakewordState(
+    AudioWorker &worker, std::shared_ptr<AudioSource> audioSampler,
+    AudioSource::Callback::Ptr detectCallback)
+    : AudioState(worker, audioSampler), m_detectCallback(detectCallback)
+{
+}
+
+AwaitWakewordState::~AwaitWakewordState() {}
+
+void AwaitWakewordState::onEnter() { listen(m_detectCallback); }
@@ -3,7 +3,7 @@
 **    ClassName: AwaitWakewordState
 **       Author: Geocat & LittleBottle
 **  Create Time: 2025/10/03 16:36
-**  Description:
+**  Description: 等待唤醒词状态：录音并把音频交给唤醒词检测回调
 *******************************************************************************/
 
 #ifndef AWAITWAKEWORDSTATE_H
@@ -16,12 +16,15 @@ class AwaitWakewordState : public AudioState
 {
 public:
     using Ptr = std::shared_ptr<AwaitWakewordState>;
-    AwaitWakewordState(AudioState::Ptr next);
+    AwaitWakewordState(AudioWorker &worker,
+                       std::shared_ptr<AudioSource> audioSampler,
+                       AudioSource::Callback::Ptr detectCallback);
     ~AwaitWakewordState();
 
-    void handle() override;
+    void onEnter() override;
 
 protected:
+    AudioSource::Callback::Ptr m_detectCallback;
 }; // class AwaitWakewordState
 
 #endif // AWAITWAKEWORDSTATE_H
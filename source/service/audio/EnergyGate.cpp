@@ -0,0 +1,78 @@
+#include "EnergyGate.h"
+
+#include "AudioPipelineConfig.h"
+#include "vad_simd.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+constexpr double kFullScale = 32768.0;
+
+double toDbfs(double amplitude, double minDbfs)
+{
+    if (amplitude <= 0)
+    {
+        return minDbfs;
+    }
+    return std::max(20.0 * std::log10(amplitude / kFullScale), minDbfs);
+}
+} // namespace
+
+void EnergyGate::configure(const AudioPipelineConfig &config)
+{
+    m_enabled = config.vadGateEnabled;
+    m_marginDb = config.vadGateMarginDb;
+    m_ceilingDbfs = config.vadGateCeilingDbfs;
+    m_floorRiseDbPerFrame =
+        kFloorRiseDbPerSecond * config.vadFrameDurationMs / 1000.0;
+}
+
+bool EnergyGate::isSilent(const int16_t *frame, size_t count)
+{
+    if (!m_enabled || count == 0)
+    {
+        return false;
+    }
+    uint64_t sumSquares = 0;
+    uint16_t peak = 0;
+    WebRtcVad_FrameLevel(frame, count, &sumSquares, &peak);
+    const double rmsDb = toDbfs(
+        std::sqrt(static_cast<double>(sumSquares) / count), kMinLevelDbfs);
+    const double peakDb = toDbfs(peak, kMinLevelDbfs);
+
+    // 先用更新前的底噪判断，避免当前帧抬高底噪后把自己判为静音
+    const double floorDb = m_hasNoiseFloor ? m_noiseFloorDb : rmsDb;
+    const bool silent =
+        rmsDb < kAlwaysSilentDbfs ||
+        (rmsDb < floorDb + m_marginDb && rmsDb < m_ceilingDbfs &&
+         peakDb < m_ceilingDbfs + kPeakAllowanceDb);
+    updateNoiseFloor(rmsDb);
+
+    m_measuredFrames.fetch_add(1, std::memory_order_relaxed);
+    if (silent)
+    {
+        m_skippedFrames.fetch_add(1, std::memory_order_relaxed);
+    }
+    return silent;
+}
+
+void EnergyGate::updateNoiseFloor(double levelDb)
+{
+    if (!m_hasNoiseFloor)
+    {
+        m_noiseFloorDb = levelDb;
+        m_hasNoiseFloor = true;
+        return;
+    }
+    // 安静时快速下降，有声音时按固定速率缓慢上升
+    if (levelDb < m_noiseFloorDb)
+    {
+        m_noiseFloorDb += (levelDb - m_noiseFloorDb) * kFloorFallRate;
+    }
+    else
+    {
+        m_noiseFloorDb =
+            std::min(m_noiseFloorDb + m_floorRiseDbPerFrame, levelDb);
+    }
+}
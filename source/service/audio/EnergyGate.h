@@ -0,0 +1,77 @@
+/*******************************************************************************
+**     FileName: EnergyGate.h
+**    ClassName: EnergyGate
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/01 09:20
+**  Description: VAD 之前的能量门限，跳过明显的静音帧
+*******************************************************************************/
+
+#ifndef ENERGYGATE_H
+#define ENERGYGATE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct AudioPipelineConfig;
+
+/**
+ * @brief Cheap pre-stage in front of the WebRTC VAD.
+ *
+ * Measures the RMS and peak level of a frame with the vectorized VAD
+ * kernels and tracks an adaptive noise floor: it follows quiet frames down
+ * quickly and rises slowly, so speech barely moves it. A frame is reported
+ * silent when it is below an absolute silence level, or when it is within
+ * marginDb of the noise floor while both its RMS and its peak stay under
+ * the ceiling; anything louder always goes to the VAD. Used from the audio
+ * processing thread only, the counters can be read from any thread.
+ */
+class EnergyGate
+{
+public:
+    /**
+     * @brief Pick up the gate settings of a configuration snapshot. The
+     * noise floor is kept, it describes the room rather than the settings.
+     */
+    void configure(const AudioPipelineConfig &config);
+
+    /**
+     * @brief Measure a frame and update the noise floor.
+     * @return true if the frame is obviously silent and the VAD can be
+     * skipped. Always false when the gate is disabled.
+     */
+    bool isSilent(const int16_t *frame, size_t count);
+
+    bool enabled() const { return m_enabled; }
+    double noiseFloorDbfs() const { return m_noiseFloorDb; }
+
+    uint64_t measuredFrames() const
+    {
+        return m_measuredFrames.load(std::memory_order_relaxed);
+    }
+    uint64_t skippedFrames() const
+    {
+        return m_skippedFrames.load(std::memory_order_relaxed);
+    }
+
+private:
+    void updateNoiseFloor(double levelDb);
+
+private:
+    static constexpr double kMinLevelDbfs = -96.0; // 16 位采样的量化下限
+    static constexpr double kAlwaysSilentDbfs = -70.0;
+    static constexpr double kPeakAllowanceDb = 20.0; // 峰值相对 RMS 门限的余量
+    static constexpr double kFloorFallRate = 0.3;
+    static constexpr double kFloorRiseDbPerSecond = 3.0;
+
+    bool m_enabled = true;
+    double m_marginDb = 6.0;
+    double m_ceilingDbfs = -45.0;
+    double m_floorRiseDbPerFrame = 0.09;
+    double m_noiseFloorDb = 0.0;
+    bool m_hasNoiseFloor = false;
+    std::atomic_uint64_t m_measuredFrames{0};
+    std::atomic_uint64_t m_skippedFrames{0};
+}; // class EnergyGate
+
+#endif // ENERGYGATE_H
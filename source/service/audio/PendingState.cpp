@@ -0,0 +1,33 @@
+#include "PendingState.h"
+
+#include "AudioPipelineConfig.h"
+#include "AudioWorker.h"
+#include "kernel/Logger.h"
+
+PendingState::PendingState(AudioWorker &worker,
+                           std::shared_ptr<AudioSource> audioSampler)
+    : AudioState(worker, audioSampler)
+{
+}
+
+PendingState::~PendingState() {}
+
+void PendingState::onEnter()
+{
+    // 等待AI服务返回检测结果期间不处理音频，但音频流继续运行：
+    // 重启音频流有几十毫秒的延迟，且这段时间内的音频会进入预录缓冲区，
+    // 下一个状态开始监听时不会丢掉用户的第一个字
+    m_audioSampler->setCallback(nullptr);
+    m_maxWaitTime = std::chrono::milliseconds(
+        AudioPipelineConfig::current()->pendingWaitTimeMs);
+    m_deadline = Clock::now() + m_maxWaitTime;
+}
+
+void PendingState::onTimeout()
+{
+    Logger::logDebug("PendingState: no result after {} ms, back to "
+                     "kAwaitWakeword",
+                     m_maxWaitTime.count());
+    m_deadline = Clock::time_point::max();
+    m_worker.setState(AudioWorker::WorkerState::kAwaitWakeword);
+}
@@ -0,0 +1,31 @@
+/*******************************************************************************
+**     FileName: PendingState.h
+**    ClassName: PendingState
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/10/30 15:20
+**  Description: 等待检测结果状态：暂停处理音频，超时后回到等待唤醒词状态
+*******************************************************************************/
+
+#ifndef PENDINGSTATE_H
+#define PENDINGSTATE_H
+
+#include "AudioState.h"
+#include <chrono>
+#include <memory>
+
+class PendingState : public AudioState
+{
+public:
+    using Ptr = std::shared_ptr<PendingState>;
+    PendingState(AudioWorker &worker,
+                 std::shared_ptr<AudioSource> audioSampler);
+    ~PendingState();
+
+    void onEnter() override;
+    void onTimeout() override;
+
+protected:
+    std::chrono::milliseconds m_maxWaitTime{0};
+}; // class PendingState
+
+#endif // PENDINGSTATE_H
@@ -1,18 +1,53 @@
 // audio/PortaudioWrapper.cpp
 #include "PortaudioWrapper.h"
+#include "AudioPipelineConfig.h"
 #include "kernel/Logger.h"
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
-#include <cstring>
-#include <kernel/Configuration.h>
 #include <memory>
 #include <mutex>
 
-PortaudioWrapper::PortaudioWrapper() : m_callback(nullptr) {}
+namespace
+{
+double toMs(uint64_t microseconds) { return microseconds / 1000.0; }
+
+std::string formatHistogram(const HistogramSnapshot &histogram)
+{
+    return fmt::format("{:.1f}/{:.1f}/{:.1f} ms",
+                       toMs(histogram.percentileMicroseconds(50)),
+                       toMs(histogram.percentileMicroseconds(99)),
+                       toMs(histogram.maxMicroseconds));
+}
+
+// 回调本身通常只有几微秒，按微秒输出
+std::string formatHistogramUs(const HistogramSnapshot &histogram)
+{
+    return fmt::format("{}/{}/{} us", histogram.percentileMicroseconds(50),
+                       histogram.percentileMicroseconds(99),
+                       histogram.maxMicroseconds);
+}
+} // namespace
+
+std::string CaptureStats::summary() const
+{
+    return fmt::format(
+        "{} callbacks, {} overflows, {} underflows, {} samples dropped, "
+        "{} buffers processed; p50/p99/max callback {}, interval {}, input "
+        "latency {}, processing lag {}, processing {}",
+        callbackDuration.count, inputOverflows, inputUnderflows,
+        droppedSamples, processedBuffers, formatHistogramUs(callbackDuration),
+        formatHistogram(callbackInterval), formatHistogram(inputLatency),
+        formatHistogram(processingLag), formatHistogram(processingDuration));
+}
+
+PortaudioWrapper::PortaudioWrapper() {}
 
 PortaudioWrapper::~PortaudioWrapper()
 {
     stopRecording();
+    stopProcessing();
     if (m_stream)
     {
         Pa_CloseStream(m_stream);
@@ -39,14 +74,24 @@ bool PortaudioWrapper::initialize()
         return false;
     }
 
-    // 从配置中读取配置参数
-    auto &config = Configuration::getInstance();
-    m_sampleRate =
-        std::get<int32_t>(config.get("/audio/sample_rate", (int32_t)16000));
-    m_sampleWidth =
-        std::get<int32_t>(config.get("/audio/sample_width", (int32_t)2));
-    m_framesPerBuffer = std::get<int32_t>(
-        config.get("/audio/frames_per_buffer", (int32_t)3200));
+    // 从配置快照中读取采样参数，音频流打开后不再变化
+    auto config = AudioPipelineConfig::current();
+    m_sampleRate = config->sampleRate;
+    m_sampleWidth = config->sampleWidth;
+    m_channels = config->channels;
+    m_framesPerBuffer = config->framesPerBuffer;
+    m_ringBufferMs = config->ringBufferMs;
+
+    // 环形缓冲区在此一次性分配，至少能容纳两个缓冲区，录音期间不再分配内存
+    size_t bufferSamples = config->samplesPerBuffer();
+    size_t ringSamples = config->samplesForMs(std::max(m_ringBufferMs, 0));
+    m_ringBuffer.resize(std::max(ringSamples, bufferSamples * 2));
+    // 每个回调一个采集时间点，按最短的回调估算数量
+    m_captureMarks.resize(m_ringBuffer.capacity() /
+                              std::max<size_t>(bufferSamples / 4, 1) +
+                          1);
+    m_processingBuffer.assign(bufferSamples, 0);
+    resizePreRoll(config->samplesForMs(std::max(config->preRollMs, 0)));
 
     PaStreamParameters inputParams;
     inputParams.device = Pa_GetDefaultInputDevice();
@@ -105,14 +150,24 @@ bool PortaudioWrapper::startRecording()
         return false;
     }
 
-    clearRecordedData();
+    // 音频线程与处理线程都未运行，此时可以安全地清空环形缓冲区
+    m_ringBuffer.clear();
+    m_captureMarks.clear();
+    m_capturedSamples = 0;
+    m_lastCallbackTime = {};
+    m_hasPendingMark = false;
+    clearPreRoll();
+    startProcessing();
+    // 先置位再启动，否则首个回调可能因尚未置位而结束音频流
+    m_isRecording = true;
     PaError err = Pa_StartStream(m_stream);
     if (err == paNoError)
     {
-        m_isRecording = true;
         unlockRecordingState();
         return true;
     }
+    m_isRecording = false;
+    stopProcessing();
     Logger::logError("PortAudio start stream error: {}", Pa_GetErrorText(err));
     unlockRecordingState();
     return false;
@@ -133,6 +188,7 @@ bool PortaudioWrapper::stopRecording()
     if (err == paNoError)
     {
         m_isRecording = false;
+        stopProcessing();
         unlockRecordingState();
         return true;
     }
@@ -143,16 +199,30 @@ bool PortaudioWrapper::stopRecording()
 
 bool PortaudioWrapper::isRecording() const { return m_isRecording; }
 
-std::vector<int16_t> PortaudioWrapper::getRecordedData() const
+uint64_t PortaudioWrapper::inputOverflowCount() const
 {
-    std::lock_guard<std::mutex> lock(m_dataMutex);
-    return m_recordedData;
+    return m_inputOverflows.load(std::memory_order_relaxed);
 }
 
-void PortaudioWrapper::clearRecordedData()
+uint64_t PortaudioWrapper::droppedSampleCount() const
 {
-    std::lock_guard<std::mutex> lock(m_dataMutex);
-    m_recordedData.clear();
+    return m_droppedSamples.load(std::memory_order_relaxed);
+}
+
+CaptureStats PortaudioWrapper::stats() const
+{
+    CaptureStats result;
+    result.inputOverflows = inputOverflowCount();
+    result.inputUnderflows = m_inputUnderflows.load(std::memory_order_relaxed);
+    result.droppedSamples = droppedSampleCount();
+    result.processedBuffers =
+        m_processedBuffers.load(std::memory_order_relaxed);
+    result.callbackDuration = m_callbackDuration.snapshot();
+    result.callbackInterval = m_callbackInterval.snapshot();
+    result.inputLatency = m_inputLatency.snapshot();
+    result.processingLag = m_processingLag.snapshot();
+    result.processingDuration = m_processingDuration.snapshot();
+    return result;
 }
 
 int PortaudioWrapper::paCallback(const void *inputBuffer, void *outputBuffer,
@@ -161,96 +231,177 @@ int PortaudioWrapper::paCallback(const void *inputBuffer, void *outputBuffer,
                                  PaStreamCallbackFlags statusFlags,
                                  void *userData)
 {
-
+    const auto callbackStart = std::chrono::steady_clock::now();
     auto *wrapper = static_cast<PortaudioWrapper *>(userData);
-    if (!wrapper->isRecording())
+    if (!wrapper->m_isRecording.load(std::memory_order_relaxed))
     {
         return paComplete;
     }
-
-    const int16_t *input = static_cast<const int16_t *>(inputBuffer);
-    std::lock_guard<std::mutex> lock(wrapper->m_dataMutex);
-
-    // 保存录制数据
-    wrapper->m_recordedData
-        .clear(); // 先清空数据，因为必要数据已经通过回调传递出去了
-    wrapper->m_recordedData.insert(wrapper->m_recordedData.end(), input,
-                                   input +
-                                       framesPerBuffer * wrapper->m_channels);
-    std::shared_ptr<PortaudioWrapper::Callback> callback = nullptr;
+    if (statusFlags & paInputOverflow)
+    {
+        wrapper->m_inputOverflows.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (statusFlags & paInputUnderflow)
     {
-        std::lock_guard<std::mutex> lock(wrapper->m_mutForChangeCallback);
-        callback = wrapper->m_callback;
+        wrapper->m_inputUnderflows.fetch_add(1, std::memory_order_relaxed);
     }
-    if (callback)
+    // 部分宿主 API 不提供 ADC 时间（为 0），此时不统计输入延迟
+    if (timeInfo != nullptr && timeInfo->inputBufferAdcTime > 0 &&
+        timeInfo->currentTime >= timeInfo->inputBufferAdcTime)
     {
-        wrapper->m_callback->onDataReady(
-            wrapper->m_recordedData, wrapper->m_sampleRate, framesPerBuffer);
+        wrapper->m_inputLatency.record(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(timeInfo->currentTime -
+                                              timeInfo->inputBufferAdcTime)));
     }
+    if (wrapper->m_lastCallbackTime !=
+        std::chrono::steady_clock::time_point{})
+    {
+        wrapper->m_callbackInterval.record(callbackStart -
+                                           wrapper->m_lastCallbackTime);
+    }
+    wrapper->m_lastCallbackTime = callbackStart;
 
+    // 处理线程跟不上时丢弃本次数据并计数，绝不在音频线程中等待
+    const size_t samples = framesPerBuffer * wrapper->m_channels;
+    if (inputBuffer != nullptr &&
+        wrapper->m_ringBuffer.tryWrite(
+            static_cast<const int16_t *>(inputBuffer), samples))
+    {
+        wrapper->m_capturedSamples += samples;
+        CaptureMark mark{wrapper->m_capturedSamples, callbackStart};
+        wrapper->m_captureMarks.tryWrite(&mark, 1);
+    }
+    else if (inputBuffer != nullptr)
+    {
+        wrapper->m_droppedSamples.fetch_add(samples,
+                                            std::memory_order_relaxed);
+    }
+    wrapper->m_callbackDuration.record(std::chrono::steady_clock::now() -
+                                       callbackStart);
     return paContinue;
 }
 
-bool PortaudioWrapper::tryLockRecordingState()
+void PortaudioWrapper::startProcessing()
 {
-    return m_mutForChangeRecordingState.try_lock();
+    if (m_processingThread.joinable())
+    {
+        return;
+    }
+    m_stopProcessing = false;
+    m_processingThread = std::thread(&PortaudioWrapper::processLoop, this);
 }
 
-bool PortaudioWrapper::unlockRecordingState()
+void PortaudioWrapper::stopProcessing()
 {
-    m_mutForChangeRecordingState.unlock();
-    return true;
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForProcessing);
+        m_stopProcessing = true;
+    }
+    m_condForProcessing.notify_all();
+    if (m_processingThread.joinable())
+    {
+        m_processingThread.join();
+    }
 }
 
-std::vector<uint8_t> PortaudioWrapper::generateWavHeader(int sampleRate,
-                                                         int channels,
-                                                         int bitsPerSample,
-                                                         size_t dataSize)
+void PortaudioWrapper::processLoop()
 {
+    const size_t bufferSamples = m_processingBuffer.size();
+    // 音频线程不做通知，处理线程以缓冲区时长的四分之一（不超过 20ms）轮询
+    const auto pollInterval = std::chrono::milliseconds(std::clamp(
+        m_framesPerBuffer * 1000 / std::max(m_sampleRate, 1) / 4, 1, 20));
 
-    std::vector<uint8_t> header(44);
-    size_t byteRate = sampleRate * channels * bitsPerSample / 8;
-    size_t blockAlign = channels * bitsPerSample / 8;
-
-    // RIFF chunk
-    header[0] = 'R';
-    header[1] = 'I';
-    header[2] = 'F';
-    header[3] = 'F';
-    uint32_t chunkSize = 36 + dataSize;
-    memcpy(&header[4], &chunkSize, 4);
-    header[8] = 'W';
-    header[9] = 'A';
-    header[10] = 'V';
-    header[11] = 'E';
-
-    // fmt subchunk
-    header[12] = 'f';
-    header[13] = 'm';
-    header[14] = 't';
-    header[15] = ' ';
-    uint32_t fmtSize = 16;
-    memcpy(&header[16], &fmtSize, 4);
-    uint16_t audioFormat = 1; // PCM
-    memcpy(&header[20], &audioFormat, 2);
-    memcpy(&header[22], &channels, 2);
-    memcpy(&header[24], &sampleRate, 4);
-    memcpy(&header[28], &byteRate, 4);
-    memcpy(&header[32], &blockAlign, 2);
-    memcpy(&header[34], &bitsPerSample, 2);
-
-    // data subchunk
-    header[36] = 'd';
-    header[37] = 'a';
-    header[38] = 't';
-    header[39] = 'a';
-    memcpy(&header[40], &dataSize, 4);
-
-    return header;
+    const auto statsInterval = std::chrono::milliseconds(
+        AudioPipelineConfig::current()->statsLogIntervalMs);
+    auto nextStatsLog = std::chrono::steady_clock::now() + statsInterval;
+    uint64_t processedSamples = 0;
+
+    while (!m_stopProcessing)
+    {
+        while (!m_stopProcessing &&
+               m_ringBuffer.tryRead(m_processingBuffer.data(), bufferSamples))
+        {
+            auto start = std::chrono::steady_clock::now();
+            processedSamples += bufferSamples;
+            recordProcessingLag(processedSamples, start);
+            dispatch(m_processingBuffer, m_sampleRate, m_framesPerBuffer);
+            m_processingDuration.record(std::chrono::steady_clock::now() -
+                                        start);
+            m_processedBuffers.fetch_add(1, std::memory_order_relaxed);
+        }
+        reportDroppedInput();
+        auto now = std::chrono::steady_clock::now();
+        if (statsInterval.count() > 0 && now >= nextStatsLog)
+        {
+            Logger::logInfo("PortaudioWrapper: {}", stats().summary());
+            nextStatsLog = now + statsInterval;
+        }
+        std::unique_lock<std::mutex> lock(m_mutexForProcessing);
+        m_condForProcessing.wait_for(lock, pollInterval,
+                                     [this] { return m_stopProcessing.load(); });
+    }
 }
 
-void PortaudioWrapper::setCallback(Callback::Ptr callback)
+void PortaudioWrapper::reportDroppedInput()
 {
-    std::unique_lock<std::mutex> lk(m_mutForChangeCallback);
-    m_callback = callback;
+    uint64_t overflows = inputOverflowCount();
+    uint64_t underflows = m_inputUnderflows.load(std::memory_order_relaxed);
+    uint64_t droppedSamples = droppedSampleCount();
+    if (overflows == m_reportedOverflows &&
+        underflows == m_reportedUnderflows &&
+        droppedSamples == m_reportedDroppedSamples)
+    {
+        return;
+    }
+    Logger::logWarning("PortaudioWrapper: {} input overflows and {} input "
+                       "underflows reported by the device, {} samples dropped "
+                       "because processing fell behind",
+                       overflows - m_reportedOverflows,
+                       underflows - m_reportedUnderflows,
+                       droppedSamples - m_reportedDroppedSamples);
+    m_reportedOverflows = overflows;
+    m_reportedUnderflows = underflows;
+    m_reportedDroppedSamples = droppedSamples;
+}
+
+void PortaudioWrapper::recordProcessingLag(
+    uint64_t processedSamples, std::chrono::steady_clock::time_point now)
+{
+    // 取出已完整处理到的所有采集时间点，以最后一个缓冲区的到达时刻计算延迟
+    bool found = false;
+    std::chrono::steady_clock::time_point captureTime;
+    while (true)
+    {
+        if (!m_hasPendingMark)
+        {
+            if (!m_captureMarks.tryRead(&m_pendingMark, 1))
+            {
+                break;
+            }
+            m_hasPendingMark = true;
+        }
+        if (m_pendingMark.endSample > processedSamples)
+        {
+            break;
+        }
+        captureTime = m_pendingMark.time;
+        found = true;
+        m_hasPendingMark = false;
+    }
+    if (found)
+    {
+        m_processingLag.record(now - captureTime);
+    }
+}
+
+bool PortaudioWrapper::tryLockRecordingState()
+{
+    return m_mutForChangeRecordingState.try_lock();
+}
+
+bool PortaudioWrapper::unlockRecordingState()
+{
+    m_mutForChangeRecordingState.unlock();
+    return true;
 }
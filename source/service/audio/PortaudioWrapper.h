@@ -10,18 +10,48 @@
 #ifndef PORTAUDIOWRAPPER_H
 #define PORTAUDIOWRAPPER_H
 
+#include "AudioSource.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
+#include <kernel/EventMetrics.h>
+#include <kernel/SPSCRingBuffer.h>
 #include <memory>
 #include <mutex>
 #include <portaudio.h>
+#include <string>
+#include <thread>
 #include <vector>
 
-class PortaudioWrapper
+/**
+ * @brief Capture timing and loss counters of a PortaudioWrapper since it
+ * was initialized, see PortaudioWrapper::stats().
+ */
+struct CaptureStats
+{
+    uint64_t inputOverflows = 0;  // 设备报告的输入溢出（驱动丢了数据）
+    uint64_t inputUnderflows = 0; // 设备报告的输入欠载（数据中有填充）
+    uint64_t droppedSamples = 0;  // 处理线程跟不上、环形缓冲区写满丢弃的样本
+    uint64_t processedBuffers = 0;
+    HistogramSnapshot callbackDuration;   // paCallback 执行耗时
+    HistogramSnapshot callbackInterval;   // 相邻两次 paCallback 的间隔
+    HistogramSnapshot inputLatency;       // ADC 采样到回调开始的时间
+    HistogramSnapshot processingLag;      // 回调收到缓冲区到处理线程开始处理
+    HistogramSnapshot processingDuration; // 处理线程处理一个缓冲区的耗时
+
+    /**
+     * @brief One-line summary for the log, durations as p50/p99/max.
+     */
+    std::string summary() const;
+};
+
+class PortaudioWrapper : public AudioSource
 {
 public:
     PortaudioWrapper();
-    ~PortaudioWrapper();
+    ~PortaudioWrapper() override;
 
     bool initialize();
     PortaudioWrapper &setSampleRate(int sampleRate);
@@ -29,35 +59,36 @@ public:
     PortaudioWrapper &setFramePerBuffer(int framesPerBuffer);
     PortaudioWrapper &setChannels(int channels);
 
-    bool startRecording();
-    bool stopRecording();
-    bool isRecording() const;
-    std::vector<int16_t> getRecordedData() const; // 获取录制的PCM数据
-    void clearRecordedData();
+    bool startRecording() override;
+    bool stopRecording() override;
+    bool isRecording() const override;
 
-    // WAV格式头部生成
-    static std::vector<uint8_t> generateWavHeader(int sampleRate, int channels,
-                                                  int bitsPerSample,
-                                                  size_t dataSize);
+    // 音频线程报告的输入溢出次数，以及环形缓冲区写满时丢弃的样本数
+    uint64_t inputOverflowCount() const;
+    uint64_t droppedSampleCount() const;
 
-    class Callback
-    {
-    public:
-        using Ptr = std::shared_ptr<Callback>;
-        virtual ~Callback() = default;
-        virtual void onDataReady(const std::vector<int16_t> &data,
-                                 int sampleRate, int samplesPerBuffer) = 0;
-        virtual void reset() = 0;
-    };
-    void setCallback(Callback::Ptr callback);
+    /**
+     * @brief Timing and loss counters. Recording them is lock-free, taking
+     * a snapshot is safe from any thread.
+     */
+    CaptureStats stats() const;
 
 protected:
     bool tryLockRecordingState();
     bool unlockRecordingState();
+    // 运行在 PortAudio 的实时线程中，只把样本拷入环形缓冲区，不加锁也不分配内存
     static int paCallback(const void *inputBuffer, void *outputBuffer,
                           unsigned long framesPerBuffer,
                           const PaStreamCallbackTimeInfo *timeInfo,
                           PaStreamCallbackFlags statusFlags, void *userData);
+    void startProcessing();
+    void stopProcessing();
+    // 处理线程：按缓冲区大小从环形缓冲区取出样本，再交给回调做 VAD 等处理
+    void processLoop();
+    void reportDroppedInput();
+    // 处理线程取出一个缓冲区后，按采集时间点记录处理延迟
+    void recordProcessingLag(uint64_t processedSamples,
+                             std::chrono::steady_clock::time_point now);
 
 private:
     PaStream *m_stream = nullptr;
@@ -65,12 +96,43 @@ private:
     int m_sampleWidth = 2;        // 16位
     int m_framesPerBuffer = 3200; // 约200ms
     int m_channels = 1;           // 单声道
-    bool m_isRecording = false;
-    std::vector<int16_t> m_recordedData;
-    mutable std::mutex m_dataMutex;
+    int m_ringBufferMs = 2000;    // 环形缓冲区可容纳的时长
+    std::atomic_bool m_isRecording{false};
+
+    SPSCRingBuffer<int16_t> m_ringBuffer;
+    std::vector<int16_t> m_processingBuffer;
+    std::thread m_processingThread;
+    // 互斥锁仅用于条件变量等待，停止标志在锁外也会读取
+    std::mutex m_mutexForProcessing;
+    std::condition_variable m_condForProcessing;
+    std::atomic_bool m_stopProcessing{false};
+    std::atomic_uint64_t m_inputOverflows{0};
+    std::atomic_uint64_t m_inputUnderflows{0};
+    std::atomic_uint64_t m_droppedSamples{0};
+    uint64_t m_reportedOverflows = 0;
+    uint64_t m_reportedUnderflows = 0;
+    uint64_t m_reportedDroppedSamples = 0;
+
+    // 采集时间点：缓冲区写入环形缓冲区后的累计样本数，以及回调开始的时刻
+    struct CaptureMark
+    {
+        uint64_t endSample;
+        std::chrono::steady_clock::time_point time;
+    };
+    SPSCRingBuffer<CaptureMark> m_captureMarks;
+    // 仅音频线程访问
+    uint64_t m_capturedSamples = 0;
+    std::chrono::steady_clock::time_point m_lastCallbackTime;
+    // 仅处理线程访问：已取出但尚未处理到的采集时间点
+    CaptureMark m_pendingMark{};
+    bool m_hasPendingMark = false;
+    std::atomic_uint64_t m_processedBuffers{0};
+    LatencyHistogram m_callbackDuration;
+    LatencyHistogram m_callbackInterval;
+    LatencyHistogram m_inputLatency;
+    LatencyHistogram m_processingLag;
+    LatencyHistogram m_processingDuration;
 
-    std::mutex m_mutForChangeCallback;
-    Callback::Ptr m_callback;
     std::mutex m_mutForChangeRecordingState;
 };
 
@@ -0,0 +1,55 @@
+#include "PreRollBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+void PreRollBuffer::resize(size_t capacity)
+{
+    m_buffer.assign(capacity, 0);
+    clear();
+}
+
+void PreRollBuffer::clear()
+{
+    m_writePos = 0;
+    m_size = 0;
+}
+
+void PreRollBuffer::push(const int16_t *samples, size_t count)
+{
+    const size_t capacity = m_buffer.size();
+    if (capacity == 0)
+    {
+        return;
+    }
+    // 超出容量的部分只保留最新的样本
+    if (count > capacity)
+    {
+        samples += count - capacity;
+        count = capacity;
+    }
+    size_t firstPart = std::min(count, capacity - m_writePos);
+    std::memcpy(m_buffer.data() + m_writePos, samples,
+                firstPart * sizeof(int16_t));
+    std::memcpy(m_buffer.data(), samples + firstPart,
+                (count - firstPart) * sizeof(int16_t));
+    m_writePos = (m_writePos + count) % capacity;
+    m_size = std::min(m_size + count, capacity);
+}
+
+void PreRollBuffer::appendTo(std::vector<int16_t> &target, size_t count) const
+{
+    count = std::min(count, m_size);
+    if (count == 0)
+    {
+        return;
+    }
+    const size_t capacity = m_buffer.size();
+    // 最新的 count 个样本紧挨在写入位置之前，可能绕过缓冲区末尾
+    size_t start = (m_writePos + capacity - count) % capacity;
+    size_t firstPart = std::min(count, capacity - start);
+    target.insert(target.end(), m_buffer.begin() + start,
+                  m_buffer.begin() + start + firstPart);
+    target.insert(target.end(), m_buffer.begin(),
+                  m_buffer.begin() + (count - firstPart));
+}
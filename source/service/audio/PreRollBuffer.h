@@ -0,0 +1,62 @@
+/*******************************************************************************
+**     FileName: PreRollBuffer.h
+**    ClassName: PreRollBuffer
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/01 16:40
+**  Description: 保存最近一段音频的循环缓冲区，用于补回语音开始前的部分
+*******************************************************************************/
+
+#ifndef PREROLLBUFFER_H
+#define PREROLLBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Fixed-size history of the most recent samples.
+ *
+ * Pushing more than the capacity keeps only the newest samples; the storage
+ * is allocated by resize() only. Not thread-safe, each instance belongs to
+ * the audio processing thread.
+ */
+class PreRollBuffer
+{
+public:
+    PreRollBuffer() = default;
+    explicit PreRollBuffer(size_t capacity) { resize(capacity); }
+
+    /**
+     * @brief Reallocate for capacity samples and drop the content. A
+     * capacity of 0 disables the buffer.
+     */
+    void resize(size_t capacity);
+    void clear();
+
+    void push(const int16_t *samples, size_t count);
+
+    /**
+     * @brief Append the content, oldest sample first, to target.
+     */
+    void appendTo(std::vector<int16_t> &target) const
+    {
+        appendTo(target, m_size);
+    }
+
+    /**
+     * @brief Append only the newest count samples (at most size()), oldest
+     * first, to target.
+     */
+    void appendTo(std::vector<int16_t> &target, size_t count) const;
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_buffer.size(); }
+    bool empty() const { return m_size == 0; }
+
+private:
+    std::vector<int16_t> m_buffer;
+    size_t m_writePos = 0; // 下一个样本的写入位置
+    size_t m_size = 0;
+}; // class PreRollBuffer
+
+#endif // PREROLLBUFFER_H
@@ -1,16 +1,37 @@
 #include "VADDetector.h"
 
-#include "kernel/Configuration.h"
+#include "AudioPipelineConfig.h"
 #include "kernel/Logger.h"
+#include "vad_simd.h"
 #include "webrtc_vad.h"
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 VADDetector::VADDetector() : m_inst(nullptr) {}
 
-VADDetector::~VADDetector() {}
+VADDetector::~VADDetector()
+{
+    if (m_inst)
+    {
+        WebRtcVad_Free(m_inst);
+    }
+}
 
 bool VADDetector::initialize()
 {
+    auto config = AudioPipelineConfig::current();
+    m_sampleRate = config->sampleRate;
+    m_frameDurationMs = config->vadFrameDurationMs;
+    m_frameLength = config->vadFrameLength();
+    m_energyGate.configure(*config);
+    if (WebRtcVad_ValidRateAndFrameLength(m_sampleRate, m_frameLength) != 0)
+    {
+        Logger::logError("Unsupported VAD frame: {} Hz, {} ms", m_sampleRate,
+                         m_frameDurationMs);
+        return false;
+    }
+
     m_inst = WebRtcVad_Create();
     int res = WebRtcVad_Init(m_inst);
     if (res != 0)
@@ -30,10 +51,11 @@ bool VADDetector::initialize()
         return false;
     }
 
+    Logger::logInfo("VADDetector: using {} VAD kernels", WebRtcVad_SimdName());
     return true;
 }
 
-bool VADDetector::isActiveAudio(const std::vector<int16_t> &audioBuffer) const
+bool VADDetector::isActiveAudio(const std::vector<int16_t> &audioBuffer)
 {
     if (m_inst == nullptr)
     {
@@ -45,28 +67,15 @@ bool VADDetector::isActiveAudio(const std::vector<int16_t> &audioBuffer) const
         Logger::logError("Input detected data is empty.");
         return false;
     }
-    auto &config = Configuration::getInstance();
-    const int32_t sampleRate =
-        std::get<int32_t>(config.get("/audio/sample_rate", (int32_t)16000));
-    const int32_t sampleWidth =
-        std::get<int32_t>(config.get("/audio/sample_width", (int32_t)2));
-    const int32_t channels =
-        std::get<int32_t>(config.get("/audio/channels", (int32_t)1));
-    const int32_t framesPerBuffer = std::get<int32_t>(
-        config.get("/audio/frames_per_buffer", (int32_t)3200));
-    const int32_t vadFrameDurationMS = std::get<int32_t>(
-        config.get("/audio/vad_frame_duration_ms", (int32_t)30));
-    // 以下为计算值
-    const int32_t frameLength = sampleRate * vadFrameDurationMS / 1000;
-    const int32_t times = framesPerBuffer / frameLength;
+    const size_t times = audioBuffer.size() / m_frameLength;
+    if (times == 0)
+    {
+        return false;
+    }
     int32_t validSlices = 0;
-    for (int i = 0; i < times; i++)
+    for (size_t i = 0; i < times; i++)
     {
-        const int16_t *pos = audioBuffer.data() + i * frameLength;
-
-        int res = WebRtcVad_Process(m_inst, sampleRate, audioBuffer.data(),
-                                    frameLength);
-        if (res == 1)
+        if (isVoicedFrame(audioBuffer.data() + i * m_frameLength))
         {
             validSlices++;
         }
@@ -74,3 +83,115 @@ bool VADDetector::isActiveAudio(const std::vector<int16_t> &audioBuffer) const
     double activeRatio = validSlices / (double)times;
     return activeRatio > 0.01;
 }
+
+bool VADDetector::isVoicedFrame(const int16_t *frame, bool useGate)
+{
+    if (useGate && m_energyGate.isSilent(frame, m_frameLength))
+    {
+        return false;
+    }
+    return m_inst != nullptr &&
+           WebRtcVad_Process(m_inst, m_sampleRate, frame, m_frameLength) == 1;
+}
+
+VADStream::VADStream(std::shared_ptr<VADDetector> detector)
+    : m_detector(detector), m_frameLength(detector->frameLength())
+{
+    m_partialFrame.resize(m_frameLength);
+    reset();
+}
+
+void VADStream::reset()
+{
+    // 时长换算为帧数，不足一帧按一帧计；帧长以检测器初始化时为准
+    auto config = AudioPipelineConfig::current();
+    const int frameMs = std::max(m_detector->frameDurationMs(), 1);
+    m_onsetFrames = std::max((config->vadOnsetMs + frameMs - 1) / frameMs, 1);
+    m_hangoverFrames =
+        std::max((config->vadHangoverMs + frameMs - 1) / frameMs, 1);
+    m_detector->energyGate().configure(*config);
+    m_onsetBuffer.resize(m_frameLength * m_onsetFrames);
+    m_partialCount = 0;
+    m_onsetCount = 0;
+    m_inSpeech = false;
+    m_silentFrames = 0;
+}
+
+void VADStream::process(const int16_t *samples, size_t count,
+                        const FrameHandler &onFrame)
+{
+    // 先补齐上次剩下的不完整帧
+    if (m_partialCount > 0)
+    {
+        size_t needed = std::min(m_frameLength - m_partialCount, count);
+        std::memcpy(m_partialFrame.data() + m_partialCount, samples,
+                    needed * sizeof(int16_t));
+        m_partialCount += needed;
+        samples += needed;
+        count -= needed;
+        if (m_partialCount < m_frameLength)
+        {
+            return;
+        }
+        m_partialCount = 0;
+        processFrame(m_partialFrame.data(), onFrame);
+    }
+    while (count >= m_frameLength)
+    {
+        processFrame(samples, onFrame);
+        samples += m_frameLength;
+        count -= m_frameLength;
+    }
+    std::memcpy(m_partialFrame.data(), samples, count * sizeof(int16_t));
+    m_partialCount = count;
+}
+
+void VADStream::processFrame(const int16_t *frame,
+                             const FrameHandler &onFrame)
+{
+    const bool voiced = m_detector->isVoicedFrame(frame, !m_inSpeech);
+    if (m_inSpeech)
+    {
+        m_silentFrames = voiced ? 0 : m_silentFrames + 1;
+        VADFrame result{frame, m_frameLength, voiced, true,
+                        VADFrame::Event::kNone};
+        if (m_silentFrames >= m_hangoverFrames)
+        {
+            m_inSpeech = false;
+            m_silentFrames = 0;
+            result.inSpeech = false;
+            result.event = VADFrame::Event::kSpeechEnd;
+        }
+        onFrame(result);
+        return;
+    }
+
+    if (!voiced)
+    {
+        // 起始阶段被打断，暂存的帧按静音输出
+        releaseOnsetFrames(false, onFrame);
+        onFrame({frame, m_frameLength, false, false, VADFrame::Event::kNone});
+        return;
+    }
+    std::memcpy(m_onsetBuffer.data() + m_onsetCount * m_frameLength, frame,
+                m_frameLength * sizeof(int16_t));
+    if (++m_onsetCount >= m_onsetFrames)
+    {
+        m_inSpeech = true;
+        m_silentFrames = 0;
+        releaseOnsetFrames(true, onFrame);
+    }
+}
+
+void VADStream::releaseOnsetFrames(bool isSpeech, const FrameHandler &onFrame)
+{
+    for (size_t i = 0; i < m_onsetCount; ++i)
+    {
+        VADFrame::Event event = isSpeech && i == 0
+                                    ? VADFrame::Event::kSpeechStart
+                                    : VADFrame::Event::kNone;
+        onFrame({m_onsetBuffer.data() + i * m_frameLength, m_frameLength,
+                 true, isSpeech, event});
+    }
+    m_onsetCount = 0;
+}
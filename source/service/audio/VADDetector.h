@@ -9,8 +9,12 @@
 #ifndef VADDETECTOR_H
 #define VADDETECTOR_H
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
+#include "EnergyGate.h"
 #include "webrtc_vad.h"
 
 class VADDetector
@@ -21,10 +25,98 @@ public:
 
     bool initialize();
 
-    bool isActiveAudio(const std::vector<int16_t> &audioBuffer) const;
+    bool isActiveAudio(const std::vector<int16_t> &audioBuffer);
+
+    /**
+     * @brief Raw WebRTC decision for one frame of frameLength() samples.
+     * @param useGate Let the energy gate answer "unvoiced" for obviously
+     * silent frames without running the WebRTC VAD.
+     */
+    bool isVoicedFrame(const int16_t *frame, bool useGate = true);
+
+    EnergyGate &energyGate() { return m_energyGate; }
+    const EnergyGate &energyGate() const { return m_energyGate; }
+
+    int sampleRate() const { return m_sampleRate; }
+    int frameDurationMs() const { return m_frameDurationMs; }
+    size_t frameLength() const { return m_frameLength; }
 
 protected:
     VadInst* m_inst;
+    int m_sampleRate = 16000;
+    int m_frameDurationMs = 30; // WebRTC VAD 只支持 10/20/30ms 的帧
+    size_t m_frameLength = 480;
+    EnergyGate m_energyGate;
 }; // class VADDetector
 
+/**
+ * @brief Smoothed decision for one VAD frame, see VADStream.
+ */
+struct VADFrame
+{
+    enum class Event
+    {
+        kNone,
+        kSpeechStart, // 本帧是一段语音的第一帧
+        kSpeechEnd,   // 本帧是语音结束后的第一个静音帧
+    };
+
+    const int16_t *samples; // 仅在回调期间有效
+    size_t count;
+    bool voiced;   // WebRTC VAD 对本帧的原始判断
+    bool inSpeech; // 平滑后本帧是否属于语音段（包括拖尾的静音帧）
+    Event event;
+};
+
+/**
+ * @brief Streaming, frame-accurate voice activity detection on top of
+ * VADDetector.
+ *
+ * Buffers of any size are cut into VAD frames; a partial frame at the end
+ * is kept for the next call. Decisions are smoothed: speech starts after
+ * onsetMs of consecutive voiced frames and ends after hangoverMs of
+ * consecutive unvoiced ones. Frames of a speech onset are held back until
+ * the onset is confirmed or rejected, so every frame is reported exactly
+ * once and in order, with its final label. The onset and hangover
+ * durations and the energy gate settings are taken from
+ * AudioPipelineConfig on every reset(). The energy gate is bypassed inside
+ * a speech segment, so pauses between words are still judged by the VAD.
+ */
+class VADStream
+{
+public:
+    using FrameHandler = std::function<void(const VADFrame &)>;
+
+    explicit VADStream(std::shared_ptr<VADDetector> detector);
+
+    /**
+     * @brief Forget the partial frame and the smoothing state, and pick up
+     * the current onset/hangover settings.
+     */
+    void reset();
+
+    void process(const int16_t *samples, size_t count,
+                 const FrameHandler &onFrame);
+
+    int frameDurationMs() const { return m_detector->frameDurationMs(); }
+    bool inSpeech() const { return m_inSpeech; }
+
+protected:
+    void processFrame(const int16_t *frame, const FrameHandler &onFrame);
+    void releaseOnsetFrames(bool isSpeech, const FrameHandler &onFrame);
+
+protected:
+    std::shared_ptr<VADDetector> m_detector;
+    size_t m_frameLength;
+    size_t m_onsetFrames = 1;
+    size_t m_hangoverFrames = 1;
+    std::vector<int16_t> m_partialFrame;
+    size_t m_partialCount = 0;
+    // 尚未确认的语音起始帧
+    std::vector<int16_t> m_onsetBuffer;
+    size_t m_onsetCount = 0;
+    bool m_inSpeech = false;
+    size_t m_silentFrames = 0;
+}; // class VADStream
+
 #endif // VADDETECTOR_H
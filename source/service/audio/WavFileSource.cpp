@@ -0,0 +1,203 @@
+#include "WavFileSource.h"
+
+#include "AudioPipelineConfig.h"
+#include "kernel/Logger.h"
+#include <algorithm>
+#include <chrono>
+
+#define DR_WAV_IMPLEMENTATION
+#include "dr_wav.h"
+
+WavFileSource::WavFileSource(Pace pace) : m_pace(pace) {}
+
+WavFileSource::~WavFileSource() { stopRecording(); }
+
+bool WavFileSource::open(const std::string &path, int32_t trailingSilenceMs)
+{
+    if (m_isRecording)
+    {
+        Logger::logError("WavFileSource: cannot open {} while playing", path);
+        return false;
+    }
+    unsigned int fileChannels = 0;
+    unsigned int fileSampleRate = 0;
+    drwav_uint64 frameCount = 0;
+    int16_t *data = drwav_open_file_and_read_pcm_frames_s16(
+        path.c_str(), &fileChannels, &fileSampleRate, &frameCount, nullptr);
+    if (data == nullptr)
+    {
+        Logger::logError("WavFileSource: failed to read {}", path);
+        return false;
+    }
+
+    auto config = AudioPipelineConfig::current();
+    bool ok = true;
+    if (static_cast<int32_t>(fileSampleRate) != config->sampleRate)
+    {
+        Logger::logError("WavFileSource: {} is {} Hz, the pipeline expects {} "
+                         "Hz",
+                         path, fileSampleRate, config->sampleRate);
+        ok = false;
+    }
+    else if (static_cast<int32_t>(fileChannels) != config->channels &&
+             config->channels != 1)
+    {
+        Logger::logError("WavFileSource: {} has {} channels, the pipeline "
+                         "expects {}",
+                         path, fileChannels, config->channels);
+        ok = false;
+    }
+    if (ok)
+    {
+        m_sampleRate = config->sampleRate;
+        m_channels = config->channels;
+        m_framesPerBuffer = config->framesPerBuffer;
+        m_samples.clear();
+        m_samples.reserve(static_cast<size_t>(frameCount) * m_channels +
+                          config->samplesForMs(trailingSilenceMs) +
+                          config->samplesPerBuffer());
+        if (static_cast<int32_t>(fileChannels) == m_channels)
+        {
+            m_samples.assign(data, data + frameCount * fileChannels);
+        }
+        else
+        {
+            // 多声道文件混合为单声道
+            for (drwav_uint64 i = 0; i < frameCount; ++i)
+            {
+                int32_t sum = 0;
+                for (unsigned int c = 0; c < fileChannels; ++c)
+                {
+                    sum += data[i * fileChannels + c];
+                }
+                m_samples.push_back(static_cast<int16_t>(
+                    sum / static_cast<int32_t>(fileChannels)));
+            }
+        }
+        m_samples.resize(m_samples.size() +
+                         config->samplesForMs(std::max(trailingSilenceMs, 0)));
+        // 最后不足一个缓冲区的部分补零
+        const size_t bufferSamples = config->samplesPerBuffer();
+        m_samples.resize((m_samples.size() + bufferSamples - 1) /
+                         bufferSamples * bufferSamples);
+        resizePreRoll(config->samplesForMs(std::max(config->preRollMs, 0)));
+    }
+    drwav_free(data, nullptr);
+    return ok;
+}
+
+void WavFileSource::setAfterBufferHook(std::function<void()> hook)
+{
+    m_afterBufferHook = std::move(hook);
+}
+
+bool WavFileSource::startRecording()
+{
+    if (m_isRecording)
+    {
+        return false;
+    }
+    if (m_playThread.joinable())
+    {
+        m_playThread.join();
+    }
+    m_position = 0;
+    clearPreRoll();
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForPlay);
+        m_stop = false;
+        m_finished = false;
+    }
+    m_isRecording = true;
+    m_playThread = std::thread(&WavFileSource::playLoop, this);
+    return true;
+}
+
+bool WavFileSource::stopRecording()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutexForPlay);
+        m_stop = true;
+    }
+    m_condForPlay.notify_all();
+    if (m_playThread.joinable())
+    {
+        m_playThread.join();
+    }
+    return m_isRecording.exchange(false);
+}
+
+bool WavFileSource::isRecording() const { return m_isRecording; }
+
+void WavFileSource::waitUntilFinished()
+{
+    std::unique_lock<std::mutex> lock(m_mutexForPlay);
+    m_condForPlay.wait(lock, [this] { return m_finished || m_stop; });
+}
+
+bool WavFileSource::isFinished() const
+{
+    std::lock_guard<std::mutex> lock(m_mutexForPlay);
+    return m_finished;
+}
+
+int64_t WavFileSource::positionMs() const
+{
+    return static_cast<int64_t>(m_position.load()) * 1000 /
+           (static_cast<int64_t>(m_sampleRate) * m_channels);
+}
+
+int64_t WavFileSource::durationMs() const
+{
+    return static_cast<int64_t>(m_samples.size()) * 1000 /
+           (static_cast<int64_t>(m_sampleRate) * m_channels);
+}
+
+void WavFileSource::playLoop()
+{
+    const size_t bufferSamples =
+        static_cast<size_t>(m_framesPerBuffer) * m_channels;
+    const auto bufferDuration =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(double(m_framesPerBuffer) /
+                                          m_sampleRate));
+    std::vector<int16_t> buffer(bufferSamples);
+    auto nextDelivery = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutexForPlay);
+    size_t offset = 0;
+    while (!m_stop && offset + bufferSamples <= m_samples.size())
+    {
+        if (m_pace == Pace::kRealtime)
+        {
+            // 按麦克风的节奏交付：每个缓冲区在录满时才交付
+            nextDelivery += bufferDuration;
+            if (m_condForPlay.wait_until(lock, nextDelivery,
+                                         [this] { return m_stop; }))
+            {
+                break;
+            }
+        }
+        else if (!hasCallback())
+        {
+            // 尽快模式下，没有回调时等待，不让状态切换期间的音频被跳过
+            m_condForPlay.wait_for(lock, kCallbackPollInterval,
+                                   [this] { return m_stop; });
+            continue;
+        }
+        lock.unlock();
+        std::copy(m_samples.begin() + offset,
+                  m_samples.begin() + offset + bufferSamples, buffer.begin());
+        offset += bufferSamples;
+        m_position = offset;
+        dispatch(buffer, m_sampleRate, m_framesPerBuffer);
+        if (m_afterBufferHook)
+        {
+            m_afterBufferHook();
+        }
+        lock.lock();
+    }
+    m_finished = true;
+    lock.unlock();
+    m_condForPlay.notify_all();
+}
@@ -0,0 +1,99 @@
+/*******************************************************************************
+**     FileName: WavFileSource.h
+**    ClassName: WavFileSource
+**       Author: Geocat & LittleBottle
+**  Create Time: 2025/11/02 10:40
+**  Description: 从 WAV 文件读取音频的音频来源，用于离线测试与性能评估
+*******************************************************************************/
+
+#ifndef WAVFILESOURCE_H
+#define WAVFILESOURCE_H
+
+#include "AudioSource.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Plays a WAV file into an AudioWorker instead of a microphone.
+ *
+ * The file must use the sample rate of the pipeline configuration; stereo
+ * files are mixed down when the pipeline is mono. Buffers have the
+ * configured size and go through the same dispatch() as the microphone.
+ * In realtime pace each buffer is delivered when a microphone would have
+ * delivered it, and audio keeps flowing while no callback is installed.
+ * As fast as possible, the source waits while no callback is installed
+ * (for example while the worker is pending), so no audio is skipped.
+ */
+class WavFileSource : public AudioSource
+{
+public:
+    enum class Pace
+    {
+        kRealtime,
+        kAsFastAsPossible,
+    };
+
+    explicit WavFileSource(Pace pace = Pace::kRealtime);
+    ~WavFileSource() override;
+
+    /**
+     * @brief Load the whole file. Must be called before startRecording().
+     * @param trailingSilenceMs Silence played after the file, so that the
+     * VAD hangover and the inactivity limits can finish the last utterance.
+     */
+    bool open(const std::string &path, int32_t trailingSilenceMs = 0);
+
+    /**
+     * @brief Called on the play thread after each buffer has been handled,
+     * for example to wait for the state change the buffer caused.
+     */
+    void setAfterBufferHook(std::function<void()> hook);
+
+    bool startRecording() override;
+    bool stopRecording() override;
+    bool isRecording() const override;
+
+    /**
+     * @brief Block until the whole file has been delivered or the source
+     * is stopped.
+     */
+    void waitUntilFinished();
+    bool isFinished() const;
+
+    /**
+     * @brief Stream time of the end of the last delivered buffer. Read from
+     * a callback it is the end of the buffer being processed.
+     */
+    int64_t positionMs() const;
+    int64_t durationMs() const;
+
+protected:
+    void playLoop();
+
+private:
+    static constexpr auto kCallbackPollInterval = std::chrono::milliseconds(1);
+
+    Pace m_pace;
+    std::vector<int16_t> m_samples;
+    int m_sampleRate = 16000;
+    int m_channels = 1;
+    int m_framesPerBuffer = 3200;
+    std::atomic<size_t> m_position{0}; // 已交付的样本数
+    std::function<void()> m_afterBufferHook;
+
+    std::thread m_playThread;
+    mutable std::mutex m_mutexForPlay;
+    std::condition_variable m_condForPlay;
+    bool m_stop = false;
+    bool m_finished = false;
+    std::atomic_bool m_isRecording{false};
+}; // class WavFileSource
+
+#endif // WAVFILESOURCE_H
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * Data parallel kernels of the VAD feature extraction, with SSE4.1, AVX2 and
+ * NEON implementations selected at runtime. The recursive all-pass and
+ * high-pass filters stay scalar.
+ *
+ * Every implementation is bit-exact with the scalar one:
+ * WebRtcVad_InitSimd() checks each candidate against the C version on a
+ * fixed set of test vectors and only installs it if all results match.
+ */
+
+#ifndef COMMON_AUDIO_VAD_VAD_SIMD_H_
+#define COMMON_AUDIO_VAD_VAD_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "signal_processing_library.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Same as WebRtcSpl_Energy(): the energy of |vector|, each square right
+// shifted by |scale_factor| so that the sum fits in 32 bits.
+typedef int32_t (*WebRtcVad_EnergyFunc)(const int16_t *vector, size_t length,
+                                        int *scale_factor);
+
+// The last step of SplitFilter() in vad_filterbank.c, in place:
+// hp_data[i] = hp_data[i] - lp_data[i], lp_data[i] = lp_data[i] + hp_data[i]
+// (with the original |hp_data[i]|), wrapping around on overflow.
+typedef void (*WebRtcVad_SplitBandsFunc)(int16_t *hp_data, int16_t *lp_data,
+                                         size_t length);
+
+// Level of a frame for the energy pre-gate in front of the VAD: the exact sum
+// of squares and the largest absolute value (32768 for -32768).
+typedef void (*WebRtcVad_FrameLevelFunc)(const int16_t *frame, size_t length,
+                                         uint64_t *sum_squares,
+                                         uint16_t *peak);
+
+extern WebRtcVad_EnergyFunc WebRtcVad_Energy;
+extern WebRtcVad_SplitBandsFunc WebRtcVad_SplitBands;
+extern WebRtcVad_FrameLevelFunc WebRtcVad_FrameLevel;
+
+int32_t WebRtcVad_EnergyC(const int16_t *vector, size_t length,
+                          int *scale_factor);
+void WebRtcVad_SplitBandsC(int16_t *hp_data, int16_t *lp_data, size_t length);
+void WebRtcVad_FrameLevelC(const int16_t *frame, size_t length,
+                           uint64_t *sum_squares, uint16_t *peak);
+
+#if defined(WEBRTC_VAD_HAS_SSE41)
+int32_t WebRtcVad_EnergySse41(const int16_t *vector, size_t length,
+                              int *scale_factor);
+void WebRtcVad_SplitBandsSse41(int16_t *hp_data, int16_t *lp_data,
+                               size_t length);
+void WebRtcVad_FrameLevelSse41(const int16_t *frame, size_t length,
+                               uint64_t *sum_squares, uint16_t *peak);
+#endif
+#if defined(WEBRTC_VAD_HAS_AVX2)
+int32_t WebRtcVad_EnergyAvx2(const int16_t *vector, size_t length,
+                             int *scale_factor);
+void WebRtcVad_SplitBandsAvx2(int16_t *hp_data, int16_t *lp_data,
+                              size_t length);
+void WebRtcVad_FrameLevelAvx2(const int16_t *frame, size_t length,
+                              uint64_t *sum_squares, uint16_t *peak);
+#endif
+#if defined(WEBRTC_VAD_HAS_NEON)
+int32_t WebRtcVad_EnergyNeon(const int16_t *vector, size_t length,
+                             int *scale_factor);
+void WebRtcVad_SplitBandsNeon(int16_t *hp_data, int16_t *lp_data,
+                              size_t length);
+void WebRtcVad_FrameLevelNeon(const int16_t *frame, size_t length,
+                              uint64_t *sum_squares, uint16_t *peak);
+#endif
+
+// Selects the fastest verified implementation for the running CPU. Called by
+// WebRtcVad_Init(); only the first call does any work.
+void WebRtcVad_InitSimd(void);
+
+// Name of the selected implementation: "avx2", "sse4.1", "neon" or "c".
+const char *WebRtcVad_SimdName(void);
+
+// Scaling of WebRtcSpl_GetScalingSquare() computed from the largest absolute
+// value, so that the SIMD versions can find |max_abs| their own way. As in
+// the scalar code, |max_abs| starts at -1 and -32768 keeps its sign.
+static __inline int WebRtcVad_ScalingFromMaxAbs(int16_t max_abs,
+                                                size_t length) {
+    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) length);
+    int16_t t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(max_abs, max_abs));
+
+    if (max_abs == 0) {
+        return 0;
+    }
+    return (t > nbits) ? 0 : nbits - t;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // COMMON_AUDIO_VAD_VAD_SIMD_H_
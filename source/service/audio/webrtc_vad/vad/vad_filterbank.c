@@ -10,6 +10,8 @@
 
 #include "include/vad_filterbank.h"
 
+#include "include/vad_simd.h"
+
 // Constants used in LogOfEnergy().
 static const int16_t kLogConst = 24660;  // 160*log10(2) in Q9.
 static const int16_t kLogEnergyIntPart = 14336;  // 14 in Q10
@@ -115,9 +117,7 @@ static void AllPassFilter(const int16_t *data_in, size_t data_length,
 static void SplitFilter(const int16_t *data_in, size_t data_length,
                         int16_t *upper_state, int16_t *lower_state,
                         int16_t *hp_data_out, int16_t *lp_data_out) {
-    size_t i;
     size_t half_length = data_length >> 1;  // Downsampling by 2.
-    int16_t tmp_out;
 
     // All-pass filtering upper branch.
     AllPassFilter(&data_in[0], half_length, kAllPassCoefsQ15[0], upper_state,
@@ -128,11 +128,7 @@ static void SplitFilter(const int16_t *data_in, size_t data_length,
                   lp_data_out);
 
     // Make LP and HP signals.
-    for (i = 0; i < half_length; i++) {
-        tmp_out = *hp_data_out;
-        *hp_data_out++ -= *lp_data_out;
-        *lp_data_out++ += tmp_out;
-    }
+    WebRtcVad_SplitBands(hp_data_out, lp_data_out, half_length);
 }
 
 // Calculates the energy of |data_in| in dB, and also updates an overall
@@ -158,8 +154,7 @@ static void LogOfEnergy(const int16_t *data_in, size_t data_length,
     RTC_DCHECK(data_in);
     RTC_DCHECK_GT(data_length, 0);
 
-    energy = (uint32_t) WebRtcSpl_Energy((int16_t *) data_in, data_length,
-                                         &tot_rshifts);
+    energy = (uint32_t) WebRtcVad_Energy(data_in, data_length, &tot_rshifts);
 
     if (energy != 0) {
         // By construction, normalizing to 15 bits is equivalent with 17 leading
@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "include/vad_simd.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#if defined(WEBRTC_VAD_HAS_SSE41) || defined(WEBRTC_VAD_HAS_AVX2)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+#endif
+
+// The longest vector used by the filter bank is 240 samples (30 ms at 8 kHz),
+// the test vectors also cover every tail length of the SIMD loops.
+enum { kTestMaxLength = 256 };
+enum { kTestRounds = 8 };
+
+WebRtcVad_EnergyFunc WebRtcVad_Energy = WebRtcVad_EnergyC;
+WebRtcVad_SplitBandsFunc WebRtcVad_SplitBands = WebRtcVad_SplitBandsC;
+WebRtcVad_FrameLevelFunc WebRtcVad_FrameLevel = WebRtcVad_FrameLevelC;
+
+static const char *g_simd_name = "c";
+
+// Several VAD instances may be created concurrently; the selection runs
+// exactly once and every caller of WebRtcVad_InitSimd() waits for it, so
+// the function pointers above are never written while another thread reads
+// them.
+#if defined(_WIN32)
+static INIT_ONCE g_simd_once = INIT_ONCE_STATIC_INIT;
+#else
+static pthread_once_t g_simd_once = PTHREAD_ONCE_INIT;
+#endif
+
+int32_t WebRtcVad_EnergyC(const int16_t *vector, size_t length,
+                          int *scale_factor) {
+    return WebRtcSpl_Energy((int16_t *) vector, length, scale_factor);
+}
+
+void WebRtcVad_SplitBandsC(int16_t *hp_data, int16_t *lp_data,
+                           size_t length) {
+    size_t i;
+    int16_t tmp_out;
+
+    for (i = 0; i < length; i++) {
+        tmp_out = hp_data[i];
+        hp_data[i] -= lp_data[i];
+        lp_data[i] += tmp_out;
+    }
+}
+
+void WebRtcVad_FrameLevelC(const int16_t *frame, size_t length,
+                           uint64_t *sum_squares, uint16_t *peak) {
+    size_t i;
+    uint64_t sum = 0;
+    uint16_t max_abs = 0;
+    uint16_t sample_abs;
+
+    for (i = 0; i < length; i++) {
+        sum += (uint64_t) ((int32_t) frame[i] * frame[i]);
+        sample_abs = (uint16_t) (frame[i] < 0 ? -(int32_t) frame[i] : frame[i]);
+        max_abs = sample_abs > max_abs ? sample_abs : max_abs;
+    }
+    *sum_squares = sum;
+    *peak = max_abs;
+}
+
+#if defined(WEBRTC_VAD_HAS_SSE41) || defined(WEBRTC_VAD_HAS_AVX2)
+#if defined(_MSC_VER)
+static int CpuHasSse41(void) {
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] >> 19) & 1;
+}
+
+static int CpuHasAvx2(void) {
+    int info[4];
+    __cpuid(info, 1);
+    // OSXSAVE and AVX, then check that the OS saves the YMM registers.
+    if (((info[2] >> 27) & 3) != 3 || (_xgetbv(0) & 6) != 6) {
+        return 0;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+}
+#else
+static int CpuHasSse41(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.1");
+}
+
+static int CpuHasAvx2(void) {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+#endif
+
+// Deterministic test signal: random samples mixed with silence, small values
+// and both extremes, so that every scaling and wrap-around case is hit.
+static void FillTestVector(int16_t *vector, size_t length, uint32_t *seed) {
+    size_t i;
+    int mode;
+
+    for (i = 0; i < length; i++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        mode = (int) (*seed >> 29);
+        if (mode == 0) {
+            vector[i] = (int16_t) ((*seed >> 8) & 1 ? -32768 : 32767);
+        } else if (mode == 1) {
+            vector[i] = 0;
+        } else if (mode == 2) {
+            vector[i] = (int16_t) ((int) ((*seed >> 8) & 0x1F) - 16);
+        } else {
+            vector[i] = (int16_t) (*seed >> 12);
+        }
+    }
+}
+
+static int IsBitExact(WebRtcVad_EnergyFunc energy,
+                      WebRtcVad_SplitBandsFunc split_bands,
+                      WebRtcVad_FrameLevelFunc frame_level) {
+    int16_t vector[kTestMaxLength];
+    int16_t hp_ref[kTestMaxLength], lp_ref[kTestMaxLength];
+    int16_t hp_out[kTestMaxLength], lp_out[kTestMaxLength];
+    uint32_t seed = 12345;
+    size_t length;
+    int round;
+    int scale_ref, scale_out;
+    uint64_t sum_ref, sum_out;
+    uint16_t peak_ref, peak_out;
+
+    for (round = 0; round < kTestRounds; round++) {
+        for (length = 1; length <= kTestMaxLength; length++) {
+            // A silent round checks the all-zero path as well.
+            if (round == 0) {
+                memset(vector, 0, sizeof(vector));
+            } else {
+                FillTestVector(vector, length, &seed);
+            }
+            if (WebRtcVad_EnergyC(vector, length, &scale_ref) !=
+                    energy(vector, length, &scale_out) ||
+                scale_ref != scale_out) {
+                return 0;
+            }
+            WebRtcVad_FrameLevelC(vector, length, &sum_ref, &peak_ref);
+            frame_level(vector, length, &sum_out, &peak_out);
+            if (sum_ref != sum_out || peak_ref != peak_out) {
+                return 0;
+            }
+
+            FillTestVector(hp_ref, length, &seed);
+            FillTestVector(lp_ref, length, &seed);
+            memcpy(hp_out, hp_ref, length * sizeof(int16_t));
+            memcpy(lp_out, lp_ref, length * sizeof(int16_t));
+            WebRtcVad_SplitBandsC(hp_ref, lp_ref, length);
+            split_bands(hp_out, lp_out, length);
+            if (memcmp(hp_ref, hp_out, length * sizeof(int16_t)) != 0 ||
+                memcmp(lp_ref, lp_out, length * sizeof(int16_t)) != 0) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+static int TrySelect(const char *name, WebRtcVad_EnergyFunc energy,
+                     WebRtcVad_SplitBandsFunc split_bands,
+                     WebRtcVad_FrameLevelFunc frame_level) {
+    if (!IsBitExact(energy, split_bands, frame_level)) {
+        return 0;
+    }
+    WebRtcVad_Energy = energy;
+    WebRtcVad_SplitBands = split_bands;
+    WebRtcVad_FrameLevel = frame_level;
+    g_simd_name = name;
+    return 1;
+}
+
+static void SelectSimd(void) {
+#if defined(WEBRTC_VAD_HAS_AVX2)
+    if (CpuHasAvx2() &&
+        TrySelect("avx2", WebRtcVad_EnergyAvx2, WebRtcVad_SplitBandsAvx2,
+                  WebRtcVad_FrameLevelAvx2)) {
+        return;
+    }
+#endif
+#if defined(WEBRTC_VAD_HAS_SSE41)
+    if (CpuHasSse41() &&
+        TrySelect("sse4.1", WebRtcVad_EnergySse41, WebRtcVad_SplitBandsSse41,
+                  WebRtcVad_FrameLevelSse41)) {
+        return;
+    }
+#endif
+#if defined(WEBRTC_VAD_HAS_NEON)
+    if (TrySelect("neon", WebRtcVad_EnergyNeon, WebRtcVad_SplitBandsNeon,
+                  WebRtcVad_FrameLevelNeon)) {
+        return;
+    }
+#endif
+}
+
+#if defined(_WIN32)
+static BOOL CALLBACK SelectSimdOnce(PINIT_ONCE once, PVOID parameter,
+                                    PVOID *context) {
+    (void) once;
+    (void) parameter;
+    (void) context;
+    SelectSimd();
+    return TRUE;
+}
+#endif
+
+void WebRtcVad_InitSimd(void) {
+#if defined(_WIN32)
+    InitOnceExecuteOnce(&g_simd_once, SelectSimdOnce, NULL, NULL);
+#else
+    pthread_once(&g_simd_once, SelectSimd);
+#endif
+}
+
+const char *WebRtcVad_SimdName(void) {
+    return g_simd_name;
+}
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Only built for AArch64, where NEON and the across-vector reductions are
+// always available.
+
+#include "include/vad_simd.h"
+
+#include <arm_neon.h>
+
+int32_t WebRtcVad_EnergyNeon(const int16_t *vector, size_t length,
+                             int *scale_factor) {
+    size_t i = 0;
+    int16_t max_abs;
+    int16_t sample_abs;
+    int scaling;
+    int32_t energy;
+    int16x8_t max_vec = vdupq_n_s16(-1);
+    int32x4_t sum_vec = vdupq_n_s32(0);
+    int32x4_t shift;
+
+    // Largest absolute value. vabsq_s16 (not the saturating vqabsq_s16) keeps
+    // |abs(-32768)| at -32768, like the scalar code.
+    for (; i + 8 <= length; i += 8) {
+        max_vec = vmaxq_s16(max_vec, vabsq_s16(vld1q_s16(vector + i)));
+    }
+    max_abs = vmaxvq_s16(max_vec);
+    for (; i < length; i++) {
+        sample_abs = (int16_t) (vector[i] > 0 ? vector[i] : -vector[i]);
+        max_abs = sample_abs > max_abs ? sample_abs : max_abs;
+    }
+
+    scaling = WebRtcVad_ScalingFromMaxAbs(max_abs, length);
+    shift = vdupq_n_s32(-scaling);  // Negative shift: arithmetic right shift.
+
+    // Each square is shifted before it is summed, as in WebRtcSpl_Energy().
+    for (i = 0; i + 8 <= length; i += 8) {
+        int16x8_t v = vld1q_s16(vector + i);
+        int32x4_t sq_lo = vmull_s16(vget_low_s16(v), vget_low_s16(v));
+        int32x4_t sq_hi = vmull_high_s16(v, v);
+        sum_vec = vaddq_s32(sum_vec, vshlq_s32(sq_lo, shift));
+        sum_vec = vaddq_s32(sum_vec, vshlq_s32(sq_hi, shift));
+    }
+    energy = vaddvq_s32(sum_vec);
+    for (; i < length; i++) {
+        energy += (vector[i] * vector[i]) >> scaling;
+    }
+
+    *scale_factor = scaling;
+    return energy;
+}
+
+void WebRtcVad_SplitBandsNeon(int16_t *hp_data, int16_t *lp_data,
+                              size_t length) {
+    size_t i = 0;
+    int16_t tmp_out;
+
+    for (; i + 8 <= length; i += 8) {
+        int16x8_t hp = vld1q_s16(hp_data + i);
+        int16x8_t lp = vld1q_s16(lp_data + i);
+        vst1q_s16(hp_data + i, vsubq_s16(hp, lp));
+        vst1q_s16(lp_data + i, vaddq_s16(lp, hp));
+    }
+    for (; i < length; i++) {
+        tmp_out = hp_data[i];
+        hp_data[i] -= lp_data[i];
+        lp_data[i] += tmp_out;
+    }
+}
+
+void WebRtcVad_FrameLevelNeon(const int16_t *frame, size_t length,
+                              uint64_t *sum_squares, uint16_t *peak) {
+    size_t i = 0;
+    uint64_t sum;
+    uint16_t max_abs;
+    uint16_t sample_abs;
+    uint16x8_t max_vec = vdupq_n_u16(0);
+    uint64x2_t sum_vec = vdupq_n_u64(0);
+
+    for (; i + 8 <= length; i += 8) {
+        int16x8_t v = vld1q_s16(frame + i);
+        // Squares are at most 2^30, exact as unsigned 32-bit values; pairs
+        // are widened to 64 bits while they are accumulated.
+        uint32x4_t sq_lo = vreinterpretq_u32_s32(
+            vmull_s16(vget_low_s16(v), vget_low_s16(v)));
+        uint32x4_t sq_hi = vreinterpretq_u32_s32(vmull_high_s16(v, v));
+        sum_vec = vpadalq_u32(sum_vec, sq_lo);
+        sum_vec = vpadalq_u32(sum_vec, sq_hi);
+        // |abs(-32768)| is 0x8000, which is 32768 as an unsigned value.
+        max_vec = vmaxq_u16(max_vec, vreinterpretq_u16_s16(vabsq_s16(v)));
+    }
+    sum = vaddvq_u64(sum_vec);
+    max_abs = vmaxvq_u16(max_vec);
+    for (; i < length; i++) {
+        sum += (uint64_t) ((int32_t) frame[i] * frame[i]);
+        sample_abs = (uint16_t) (frame[i] < 0 ? -(int32_t) frame[i] : frame[i]);
+        max_abs = sample_abs > max_abs ? sample_abs : max_abs;
+    }
+    *sum_squares = sum;
+    *peak = max_abs;
+}
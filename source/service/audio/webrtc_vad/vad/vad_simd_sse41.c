@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2012 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "include/vad_simd.h"
+
+#include <smmintrin.h>
+
+int32_t WebRtcVad_EnergySse41(const int16_t *vector, size_t length,
+                              int *scale_factor) {
+    size_t i = 0;
+    int16_t max_abs;
+    int16_t sample_abs;
+    int scaling;
+    int32_t energy;
+    __m128i max_vec = _mm_set1_epi16(-1);
+    __m128i sum_vec = _mm_setzero_si128();
+    __m128i shift;
+
+    // Largest absolute value. Like the scalar code, |abs(-32768)| wraps to
+    // -32768 and never wins the signed maximum.
+    for (; i + 8 <= length; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (vector + i));
+        max_vec = _mm_max_epi16(max_vec, _mm_abs_epi16(v));
+    }
+    max_vec = _mm_max_epi16(max_vec, _mm_shuffle_epi32(max_vec, 0x4E));
+    max_vec = _mm_max_epi16(max_vec, _mm_shuffle_epi32(max_vec, 0xB1));
+    max_vec = _mm_max_epi16(max_vec, _mm_shufflelo_epi16(max_vec, 0xB1));
+    max_abs = (int16_t) _mm_extract_epi16(max_vec, 0);
+    for (; i < length; i++) {
+        sample_abs = (int16_t) (vector[i] > 0 ? vector[i] : -vector[i]);
+        max_abs = sample_abs > max_abs ? sample_abs : max_abs;
+    }
+
+    scaling = WebRtcVad_ScalingFromMaxAbs(max_abs, length);
+    shift = _mm_cvtsi32_si128(scaling);
+
+    // Each square is shifted before it is summed, as in WebRtcSpl_Energy().
+    for (i = 0; i + 8 <= length; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (vector + i));
+        __m128i lo = _mm_mullo_epi16(v, v);
+        __m128i hi = _mm_mulhi_epi16(v, v);
+        sum_vec = _mm_add_epi32(
+            sum_vec, _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), shift));
+        sum_vec = _mm_add_epi32(
+            sum_vec, _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), shift));
+    }
+    sum_vec = _mm_add_epi32(sum_vec, _mm_shuffle_epi32(sum_vec, 0x4E));
+    sum_vec = _mm_add_epi32(sum_vec, _mm_shuffle_epi32(sum_vec, 0xB1));
+    energy = _mm_cvtsi128_si32(sum_vec);
+    for (; i < length; i++) {
+        energy += (vector[i] * vector[i]) >> scaling;
+    }
+
+    *scale_factor = scaling;
+    return energy;
+}
+
+void WebRtcVad_SplitBandsSse41(int16_t *hp_data, int16_t *lp_data,
+                               size_t length) {
+    size_t i = 0;
+    int16_t tmp_out;
+
+    for (; i + 8 <= length; i += 8) {
+        __m128i hp = _mm_loadu_si128((const __m128i *) (hp_data + i));
+        __m128i lp = _mm_loadu_si128((const __m128i *) (lp_data + i));
+        _mm_storeu_si128((__m128i *) (hp_data + i), _mm_sub_epi16(hp, lp));
+        _mm_storeu_si128((__m128i *) (lp_data + i), _mm_add_epi16(lp, hp));
+    }
+    for (; i < length; i++) {
+        tmp_out = hp_data[i];
+        hp_data[i] -= lp_data[i];
+        lp_data[i] += tmp_out;
+    }
+}
+
+void WebRtcVad_FrameLevelSse41(const int16_t *frame, size_t length,
+                               uint64_t *sum_squares, uint16_t *peak) {
+    size_t i = 0;
+    uint64_t sum;
+    uint16_t max_abs;
+    uint16_t sample_abs;
+    uint64_t sums[2];
+    __m128i max_vec = _mm_setzero_si128();
+    __m128i sum_vec = _mm_setzero_si128();
+
+    for (; i + 8 <= length; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (frame + i));
+        // A pair of squares is at most 2^31: exact as an unsigned 32-bit
+        // value, then widened to 64 bits before it is accumulated.
+        __m128i pairs = _mm_madd_epi16(v, v);
+        sum_vec = _mm_add_epi64(sum_vec, _mm_cvtepu32_epi64(pairs));
+        sum_vec = _mm_add_epi64(
+            sum_vec, _mm_cvtepu32_epi64(_mm_srli_si128(pairs, 8)));
+        // |abs(-32768)| is 0x8000, which is 32768 as an unsigned value.
+        max_vec = _mm_max_epu16(max_vec, _mm_abs_epi16(v));
+    }
+    _mm_storeu_si128((__m128i *) sums, sum_vec);
+    sum = sums[0] + sums[1];
+    max_vec = _mm_max_epu16(max_vec, _mm_shuffle_epi32(max_vec, 0x4E));
+    max_vec = _mm_max_epu16(max_vec, _mm_shuffle_epi32(max_vec, 0xB1));
+    max_vec = _mm_max_epu16(max_vec, _mm_shufflelo_epi16(max_vec, 0xB1));
+    max_abs = (uint16_t) _mm_extract_epi16(max_vec, 0);
+    for (; i < length; i++) {
+        sum += (uint64_t) ((int32_t) frame[i] * frame[i]);
+        sample_abs = (uint16_t) (frame[i] < 0 ? -(int32_t) frame[i] : frame[i]);
+        max_abs = sample_abs > max_abs ? sample_abs : max_abs;
+    }
+    *sum_squares = sum;
+    *peak = max_abs;
+}
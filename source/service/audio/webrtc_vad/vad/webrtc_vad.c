@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include "include/vad_core.h"
+#include "include/vad_simd.h"
 
 static const int kInitCheck = 42;
 static const int kValidRates[] = {8000, 16000, 32000, 48000};
@@ -33,6 +34,8 @@ void WebRtcVad_Free(VadInst *handle) {
 
 // TODO(bjornv): Move WebRtcVad_InitCore() code here.
 int WebRtcVad_Init(VadInst *handle) {
+    // Select the SIMD kernels for this CPU.
+    WebRtcVad_InitSimd();
     // Initialize the core VAD component.
     return WebRtcVad_InitCore((VadInstT *) handle);
 }
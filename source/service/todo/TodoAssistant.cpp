@@ -213,37 +213,70 @@ public:
     }
     virtual bool execute() override
     {
-        Todo todo;
-        if (!getTodo(m_params["title"], todo))
+        // 在 AI 的事件处理线程中执行，不等待查询结果：查到待办后在应答线程中继续更新。
+        // 操作对象会被下一次请求复用，回调持有参数的副本
+        TodoEvents::GetTodoRequest request;
+        request.time = std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+        request.title = m_params["title"];
+        EventBus::getInstance().request<TodoEvents::GetTodoRequest>(
+            request,
+            [params = m_params](std::future<std::optional<Todo>> future)
+            {
+                try
+                {
+                    auto result = future.get();
+                    if (!result)
+                    {
+                        Logger::logError("UpdateTodoOperator::execute: todo {} not found",
+                                         params.at("title"));
+                        return;
+                    }
+                    update(*result, params);
+                }
+                catch (const std::exception &e)
+                {
+                    Logger::logError("UpdateTodoOperator::execute: failed to get todo: {}",
+                                     e.what());
+                }
+            });
+        return true;
+    }
+
+protected:
+    static void update(Todo todo, const std::map<std::string, std::string> &params)
+    {
+        auto param = [&params](const char *key) -> const std::string *
         {
-            Logger::logError("UpdateTodoOperator::execute: failed to get todo");
-            return false;
-        }
-        if (m_params.find("content") != m_params.end())
+            auto it = params.find(key);
+            return it == params.end() ? nullptr : &it->second;
+        };
+        if (auto value = param("content"))
         {
-            todo.content = m_params["content"];
+            todo.content = *value;
         }
-        if (m_params.find("dueTime") != m_params.end())
+        if (auto value = param("dueTime"))
         {
             date::sys_seconds tp;
-            std::istringstream dueTimeStream(m_params["dueTime"]);
+            std::istringstream dueTimeStream(*value);
             dueTimeStream >> date::parse("%Y-%m-%d %H:%M:%S", tp);
             todo.dueTime = tp;
         }
-        if (m_params.find("reminderTime") != m_params.end())
+        if (auto value = param("reminderTime"))
         {
             date::sys_seconds tp;
-            std::istringstream reminderTimeStream(m_params["reminderTime"]);
+            std::istringstream reminderTimeStream(*value);
             reminderTimeStream >> date::parse("%Y-%m-%d %H:%M:%S", tp);
             todo.reminderTime = tp;
         }
-        if (m_params.find("priority") != m_params.end())
+        if (auto value = param("priority"))
         {
-            todo.priority = parsePriority(m_params["priority"]);
+            todo.priority = parsePriority(*value);
         }
-        if (m_params.find("status") != m_params.end())
+        if (auto value = param("status"))
         {
-            todo.status = parseStatus(m_params["status"]);
+            todo.status = parseStatus(*value);
         }
 
         TodoEvents::UpdateTodoEvent updateEvent;
@@ -252,20 +285,6 @@ public:
                                .count();
         updateEvent.item = todo;
         EventBus::getInstance().publish_async<TodoEvents::UpdateTodoEvent>(updateEvent);
-        return true;
-    }
-
-protected:
-    bool getTodo(const std::string &title, Todo &todo)
-    {
-        TodoEvents::GetTodoEvent getEvent;
-        getEvent.time = std::chrono::duration_cast<std::chrono::seconds>(
-                            std::chrono::system_clock::now().time_since_epoch())
-                            .count();
-        getEvent.title = title;
-        getEvent.receiver = [&todo](const Todo &item) { todo = item; };
-        EventBus::getInstance().publish_async<TodoEvents::GetTodoEvent>(getEvent);
-        return true;
     }
 };
 
@@ -299,11 +318,25 @@ public:
     }
     virtual bool execute() override
     {
-        TodoEvents::GetTodosByEvent getEvent;
-        getEvent.time = std::chrono::duration_cast<std::chrono::seconds>(
-                            std::chrono::system_clock::now().time_since_epoch())
-                            .count();
-        getEvent.sql = m_params["sql"];
+        TodoEvents::GetTodosByRequest request;
+        request.time = std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+        request.sql = m_params["sql"];
+        EventBus::getInstance().request<TodoEvents::GetTodosByRequest>(
+            request,
+            [](std::future<std::vector<Todo>> future)
+            {
+                try
+                {
+                    Logger::logInfo("GetByOperator::execute: {} todos found",
+                                    future.get().size());
+                }
+                catch (const std::exception &e)
+                {
+                    Logger::logError("GetByOperator::execute: {}", e.what());
+                }
+            });
         return true;
     }
 };
@@ -15,6 +15,7 @@
 #include <kernel/entities/Entity.h>
 #include <kernel/entities/Todo.h>
 #include <memory>
+#include <optional>
 #include <service/todo/TodoService.h>
 #include <vector>
 
@@ -119,55 +120,18 @@ struct TodoService::Data
                              event.item.title.c_str());
         }
     }
-    void getTodo(const TodoEvents::GetTodoEvent &event)
-    {
-        auto &db = DatabaseManager::getInstance();
-        auto conn = db.getTodoConnection();
-        if (!conn)
-        {
-            return;
-        }
-        struct GetCondition : public DatabaseConnection::Condition
-        {
-            std::string column;
-            std::string value;
-
-            std::string operator()() const override { return column + " = '" + value + "'"; }
-        };
-        GetCondition gc;
-        gc.column = "title";
-        gc.value = event.title;
-        std::vector<std::shared_ptr<Entity>> results;
-        conn->find("todos", gc, results);
-        if (results.empty())
-        {
-            return;
-        }
-        auto todo = std::dynamic_pointer_cast<Todo>(results[0]);
-        if (todo)
-        {
-            event.receiver(*todo);
-        }
-    }
-    void getAllTodos(const TodoEvents::GetAllTodosEvent &event)
+    // 按条件查询待办，连接不可用时返回空列表
+    std::vector<Todo> findTodos(const DatabaseConnection::Condition &condition)
     {
+        std::vector<Todo> todos;
         auto &db = DatabaseManager::getInstance();
         auto conn = db.getTodoConnection();
         if (!conn)
         {
-            return;
+            return todos;
         }
-        struct FindAllCondition : public DatabaseConnection::Condition
-        {
-            std::string operator()() const override { return ""; }
-        } fac;
         std::vector<std::shared_ptr<Entity>> results;
-        conn->find("todos", fac, results);
-        if (results.empty())
-        {
-            return;
-        }
-        std::vector<Todo> todos;
+        conn->find("todos", condition, results);
         for (auto &result : results)
         {
             auto todo = std::dynamic_pointer_cast<Todo>(result);
@@ -176,69 +140,58 @@ struct TodoService::Data
                 todos.push_back(*todo);
             }
         }
-        event.receiver(todos);
+        return todos;
     }
-    void getTodosBy(const TodoEvents::GetTodosByEvent &event)
+    std::vector<Todo> findAllTodos()
     {
-        auto &db = DatabaseManager::getInstance();
-        auto conn = db.getTodoConnection();
-        if (!conn)
-        {
-            return;
-        }
         struct FindAllCondition : public DatabaseConnection::Condition
         {
             std::string operator()() const override { return ""; }
         } fac;
-        std::vector<std::shared_ptr<Entity>> results;
-        conn->find("todos", fac, results);
-        if (results.empty())
+        return findTodos(fac);
+    }
+    std::optional<Todo> getTodo(const TodoEvents::GetTodoRequest &request)
+    {
+        struct GetCondition : public DatabaseConnection::Condition
         {
-            return;
-        }
-        std::vector<Todo> todos;
-        for (auto &result : results)
+            std::string column;
+            std::string value;
+
+            std::string operator()() const override { return column + " = '" + value + "'"; }
+        };
+        GetCondition gc;
+        gc.column = "title";
+        gc.value = request.title;
+        auto todos = findTodos(gc);
+        if (todos.empty())
         {
-            auto todo = std::dynamic_pointer_cast<Todo>(result);
-            if (todo)
-            {
-                todos.push_back(*todo);
-            }
+            return std::nullopt;
         }
-        todos.erase(std::remove_if(todos.begin(), todos.end(),
-                                   [&](const Todo &todo) { return !event.filter(todo); }),
-                    todos.end());
-        event.receiver(todos);
+        return todos.front();
     }
-    void orderTodosBy(const TodoEvents::OrderTodosByEvent &event)
+    std::vector<Todo> getAllTodos(const TodoEvents::GetAllTodosRequest &)
     {
-        auto &db = DatabaseManager::getInstance();
-        auto conn = db.getTodoConnection();
-        if (!conn)
-        {
-            return;
-        }
-        struct FindAllCondition : public DatabaseConnection::Condition
-        {
-            std::string operator()() const override { return ""; }
-        } fac;
-        std::vector<std::shared_ptr<Entity>> results;
-        conn->find("todos", fac, results);
-        if (results.empty())
+        return findAllTodos();
+    }
+    std::vector<Todo> getTodosBy(const TodoEvents::GetTodosByRequest &request)
+    {
+        auto todos = findAllTodos();
+        if (request.filter)
         {
-            return;
+            todos.erase(std::remove_if(todos.begin(), todos.end(),
+                                       [&](const Todo &todo) { return !request.filter(todo); }),
+                        todos.end());
         }
-        std::vector<Todo> todos;
-        for (auto &result : results)
+        return todos;
+    }
+    std::vector<Todo> orderTodosBy(const TodoEvents::OrderTodosByRequest &request)
+    {
+        auto todos = findAllTodos();
+        if (request.compare)
         {
-            auto todo = std::dynamic_pointer_cast<Todo>(result);
-            if (todo)
-            {
-                todos.push_back(*todo);
-            }
+            std::sort(todos.begin(), todos.end(), request.compare);
         }
-        std::sort(todos.begin(), todos.end(), event.compare);
-        event.receiver(todos);
+        return todos;
     }
 
     Data()
@@ -253,13 +206,13 @@ struct TodoService::Data
             std::bind(&TodoService::Data::deleteTodo, this, std::placeholders::_1));
         updateTodoSubscription = EventBus::getInstance().on<TodoEvents::UpdateTodoEvent>(
             std::bind(&TodoService::Data::updateTodo, this, std::placeholders::_1));
-        getTodoSubscription = EventBus::getInstance().on<TodoEvents::GetTodoEvent>(
+        getTodoSubscription = EventBus::getInstance().respond<TodoEvents::GetTodoRequest>(
             std::bind(&TodoService::Data::getTodo, this, std::placeholders::_1));
-        getAllTodosSubscription = EventBus::getInstance().on<TodoEvents::GetAllTodosEvent>(
+        getAllTodosSubscription = EventBus::getInstance().respond<TodoEvents::GetAllTodosRequest>(
             std::bind(&TodoService::Data::getAllTodos, this, std::placeholders::_1));
-        getTodosBySubscription = EventBus::getInstance().on<TodoEvents::GetTodosByEvent>(
+        getTodosBySubscription = EventBus::getInstance().respond<TodoEvents::GetTodosByRequest>(
             std::bind(&TodoService::Data::getTodosBy, this, std::placeholders::_1));
-        orderTodosBySubscription = EventBus::getInstance().on<TodoEvents::OrderTodosByEvent>(
+        orderTodosBySubscription = EventBus::getInstance().respond<TodoEvents::OrderTodosByRequest>(
             std::bind(&TodoService::Data::orderTodosBy, this, std::placeholders::_1));
 
 #ifdef GA_DEBUG
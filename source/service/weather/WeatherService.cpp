@@ -4,8 +4,8 @@
 #include <cstdint>
 #include <kernel/IService.h>
 #include <memory>
+#include <mutex>
 #include <service/weather/WeatherService.h>
-#include <thread>
 
 #include "AMapWeatherFetcher.h"
 #include "IPLocator.h"
@@ -13,14 +13,30 @@
 #include "kernel/Logger.h"
 #include "kernel/WeatherInfo.h"
 #include <kernel/EventBus.h>
+#include <kernel/Executor.h>
 #include <kernel/Events.h>
 
+namespace
+{
+constexpr std::chrono::hours kRefreshInterval(3);
+
+// 定时刷新任务在共享线程池上执行，任务持有该状态，服务停止后不再续期
+struct RefreshState
+{
+    std::mutex mutex;
+    bool running = true;
+    uint64_t timerId = 0;
+};
+
+void scheduleRefresh(const std::shared_ptr<RefreshState> &state);
+} // namespace
+
 struct WeatherService::Data
 {
     std::shared_ptr<WeatherFetcher> fetcher;
     std::shared_ptr<IPLocator> locator;
     std::atomic_bool running;
-    std::thread workerThread;
+    std::shared_ptr<RefreshState> refreshState;
     Subscription requestSubscription;
     bool initialized;
 
@@ -55,40 +71,41 @@ bool WeatherService::initialize()
     m_data->locator = std::make_shared<AMapIPLocator>();
     m_data->initialized = true;
 
-    // 订阅天气请求事件
+    // 订阅天气请求事件，网络请求耗时较长，放到后台通道执行
     m_data->requestSubscription =
         EventBus::getInstance().on<WeatherEvents::WeatherRequestEvent>(
-            updateWeather);
+            updateWeather,
+            SubscriptionOptions().setPriority(EventPriority::kBackground));
     return true;
 }
 
+namespace
+{
+void scheduleRefresh(const std::shared_ptr<RefreshState> &state)
+{
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->running)
+    {
+        return;
+    }
+    state->timerId = Executor::getInstance().schedule(
+        kRefreshInterval,
+        [state]()
+        {
+            updateWeather({});
+            scheduleRefresh(state);
+        },
+        EventPriority::kBackground);
+}
+} // namespace
+
 bool WeatherService::start()
 {
     if (!m_data->running)
     {
         m_data->running = true;
-        auto func = [&]()
-        {
-            auto startTime = std::chrono::system_clock::now();
-            constexpr uint64_t duration = 60 * 60 * 3; // 3小时，s
-            while (m_data->running)
-            {
-                auto now = std::chrono::system_clock::now();
-                auto diff = std::chrono::duration_cast<std::chrono::seconds>(
-                                now - startTime)
-                                .count();
-                if (diff >= duration)
-                {
-                    updateWeather({});
-                    startTime = now;
-                }
-                else
-                {
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
-                }
-            }
-        };
-        m_data->workerThread = std::thread(func);
+        m_data->refreshState = std::make_shared<RefreshState>();
+        scheduleRefresh(m_data->refreshState);
     }
     return true;
 }
@@ -99,9 +116,11 @@ void WeatherService::shutdown()
     {
         m_data->requestSubscription.unsubscribe();
         m_data->running = false;
-        if (m_data->workerThread.joinable())
+        if (m_data->refreshState)
         {
-            m_data->workerThread.join();
+            std::lock_guard<std::mutex> lock(m_data->refreshState->mutex);
+            m_data->refreshState->running = false;
+            Executor::getInstance().cancel(m_data->refreshState->timerId);
         }
     }
     Logger::logInfo("WeatherService shutdown.");
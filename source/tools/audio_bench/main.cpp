@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kernel/Configuration.h>
+#include <kernel/EventBus.h>
+#include <kernel/Events.h>
+#include <kernel/Logger.h>
+
+#include "AudioPipelineConfig.h"
+#include "AudioWorker.h"
+#include "VADDetector.h"
+#include "WavFileSource.h"
+#include "vad_simd.h"
+
+namespace
+{
+// 标注区间与检测出的语音片段，单位均为音频流中的毫秒
+struct Interval
+{
+    int64_t startMs;
+    int64_t endMs;
+};
+
+struct Segment
+{
+    Interval range;
+    bool hasSpeech; // 内容识别超时（没有说话）时发出的片段为 false
+};
+
+struct FileResult
+{
+    int64_t audioMs = 0;
+    int64_t wallMs = 0;
+    size_t labels = 0;
+    size_t detectedLabels = 0;
+    size_t segments = 0;
+    size_t matchedSegments = 0;
+    std::vector<int64_t> latenciesMs; // 片段结束相对标注结束的延迟
+};
+
+struct Options
+{
+    AudioWorker::WorkerState mode = AudioWorker::WorkerState::kAwaitWakeword;
+    WavFileSource::Pace pace = WavFileSource::Pace::kAsFastAsPossible;
+    int32_t trailingSilenceMs = 3000;
+    int32_t framesPerBuffer = 0;
+    std::vector<std::filesystem::path> files;
+};
+
+void printUsage(const char *program)
+{
+    std::printf(
+        "Usage: %s [options] <file.wav|directory>...\n"
+        "  --mode <wakeword|content>  callback to benchmark (default "
+        "wakeword)\n"
+        "  --realtime                 deliver audio at microphone pace\n"
+        "  --tail-ms <ms>             silence appended to each file "
+        "(default 3000)\n"
+        "  --frames-per-buffer <n>    override /audio/frames_per_buffer, "
+        "smaller buffers give finer latency figures\n"
+        "Speech labels are read from <file>.txt next to each WAV file, one "
+        "\"start<TAB>end[<TAB>text]\" line per utterance in seconds (an "
+        "Audacity label track).\n",
+        program);
+}
+
+bool parseOptions(int argc, char *argv[], Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--mode" && i + 1 < argc)
+        {
+            std::string mode = argv[++i];
+            if (mode == "wakeword")
+            {
+                options.mode = AudioWorker::WorkerState::kAwaitWakeword;
+            }
+            else if (mode == "content")
+            {
+                options.mode = AudioWorker::WorkerState::kAwaitContent;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (arg == "--realtime")
+        {
+            options.pace = WavFileSource::Pace::kRealtime;
+        }
+        else if (arg == "--tail-ms" && i + 1 < argc)
+        {
+            options.trailingSilenceMs = std::atoi(argv[++i]);
+        }
+        else if (arg == "--frames-per-buffer" && i + 1 < argc)
+        {
+            options.framesPerBuffer = std::atoi(argv[++i]);
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            return false;
+        }
+        else if (std::filesystem::is_directory(arg))
+        {
+            std::vector<std::filesystem::path> found;
+            for (const auto &entry : std::filesystem::directory_iterator(arg))
+            {
+                if (entry.path().extension() == ".wav")
+                {
+                    found.push_back(entry.path());
+                }
+            }
+            std::sort(found.begin(), found.end());
+            options.files.insert(options.files.end(), found.begin(),
+                                 found.end());
+        }
+        else
+        {
+            options.files.emplace_back(arg);
+        }
+    }
+    return !options.files.empty();
+}
+
+std::vector<Interval> loadLabels(const std::filesystem::path &wavPath)
+{
+    std::vector<Interval> labels;
+    std::filesystem::path labelPath = wavPath;
+    labelPath.replace_extension(".txt");
+    std::ifstream file(labelPath);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        double start = 0;
+        double end = 0;
+        if (stream >> start >> end && end >= start)
+        {
+            labels.push_back({static_cast<int64_t>(start * 1000),
+                              static_cast<int64_t>(end * 1000)});
+        }
+    }
+    return labels;
+}
+
+bool overlaps(const Interval &a, const Interval &b)
+{
+    return a.startMs < b.endMs && b.startMs < a.endMs;
+}
+
+// 标注与片段按时间重叠匹配：被任一片段覆盖的标注算检出，
+// 不与任何标注重叠的片段算误触发
+void score(const std::vector<Interval> &labels,
+           const std::vector<Segment> &segments, FileResult &result)
+{
+    result.labels = labels.size();
+    for (const auto &segment : segments)
+    {
+        if (!segment.hasSpeech)
+        {
+            continue;
+        }
+        ++result.segments;
+        if (std::any_of(labels.begin(), labels.end(),
+                        [&](const Interval &label)
+                        { return overlaps(label, segment.range); }))
+        {
+            ++result.matchedSegments;
+        }
+    }
+    for (const auto &label : labels)
+    {
+        auto first = std::find_if(segments.begin(), segments.end(),
+                                  [&](const Segment &segment)
+                                  {
+                                      return segment.hasSpeech &&
+                                             overlaps(label, segment.range);
+                                  });
+        if (first != segments.end())
+        {
+            ++result.detectedLabels;
+            result.latenciesMs.push_back(first->range.endMs - label.endMs);
+        }
+    }
+}
+
+FileResult runFile(const std::filesystem::path &path, const Options &options,
+                   std::shared_ptr<VADDetector> vadDetector)
+{
+    FileResult result;
+    auto source = std::make_shared<WavFileSource>(options.pace);
+    if (!source->open(path.string(), options.trailingSilenceMs))
+    {
+        return result;
+    }
+    auto worker = std::make_shared<AudioWorker>(source, vadDetector);
+    if (options.pace == WavFileSource::Pace::kAsFastAsPossible)
+    {
+        // 尽快模式下每个缓冲区处理完后等待状态切换完成，与麦克风下的行为一致
+        source->setAfterBufferHook([&worker] { worker->waitUntilSettled(); });
+    }
+
+    const double samplesPerMs =
+        AudioPipelineConfig::current()->samplesForMs(1000) / 1000.0;
+    std::mutex mutexForSegments;
+    std::vector<Segment> segments;
+    // 内联订阅：在处理线程发布事件时记录，此时音频位置正是触发片段结束的缓冲区
+    auto record = [&](const PooledBuffer<int16_t> &audioData)
+    {
+        int64_t endMs = source->positionMs();
+        int64_t lengthMs = static_cast<int64_t>(audioData.size() / samplesPerMs);
+        // 内容识别超时（没有说话）时，回调先切回等待唤醒词状态再发送事件；
+        // 主线程在片段记录之后才会改回被测状态，因此这里读到的状态是准确的
+        bool hasSpeech =
+            worker->state() != AudioWorker::WorkerState::kAwaitWakeword ||
+            options.mode == AudioWorker::WorkerState::kAwaitWakeword;
+        std::lock_guard<std::mutex> lock(mutexForSegments);
+        segments.push_back({{endMs - lengthMs, endMs}, hasSpeech});
+    };
+    auto inlineOptions = SubscriptionOptions().setInlineDelivery(true);
+    auto &bus = EventBus::getInstance();
+    Subscription wakewordSubscription =
+        bus.on<AudioEvents::CheckIsWakewordEvent>(
+            [&](const AudioEvents::CheckIsWakewordEvent &event)
+            { record(event.audioData); },
+            inlineOptions);
+    Subscription contentSubscription =
+        bus.on<AudioEvents::AudioContentRecordingDoneEvent>(
+            [&](const AudioEvents::AudioContentRecordingDoneEvent &event)
+            { record(event.audioData); },
+            inlineOptions);
+
+    auto startTime = std::chrono::steady_clock::now();
+    worker->setState(options.mode);
+    worker->start();
+    // 代替 AI 服务：每个片段发出、工作线程离开被测状态后，立即切回被测状态
+    size_t handledSegments = 0;
+    while (!source->isFinished())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutexForSegments);
+            if (segments.size() > handledSegments &&
+                worker->state() != options.mode)
+            {
+                handledSegments = segments.size();
+                worker->setState(options.mode);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    worker->stop();
+    result.wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - startTime)
+                        .count();
+    result.audioMs = source->durationMs();
+
+    std::lock_guard<std::mutex> lock(mutexForSegments);
+    score(loadLabels(path), segments, result);
+    return result;
+}
+
+void printResult(const std::string &name, const FileResult &result)
+{
+    std::vector<int64_t> latencies = result.latenciesMs;
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) -> int64_t
+    {
+        if (latencies.empty())
+        {
+            return 0;
+        }
+        return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+    std::printf("%-32s audio %8.1f s  %7.1fx realtime  segments %4zu  "
+                "recall %3zu/%-3zu  precision %3zu/%-3zu  latency p50 %5lld "
+                "ms  p95 %5lld ms\n",
+                name.c_str(), result.audioMs / 1000.0,
+                result.wallMs > 0 ? double(result.audioMs) / result.wallMs
+                                  : 0.0,
+                result.segments, result.detectedLabels, result.labels,
+                result.matchedSegments, result.segments,
+                static_cast<long long>(percentile(0.5)),
+                static_cast<long long>(percentile(0.95)));
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto &config = Configuration::getInstance();
+    config.loadFromFile();
+    if (options.framesPerBuffer > 0)
+    {
+        config.set("/audio/frames_per_buffer",
+                   Configuration::ConfigValueType(options.framesPerBuffer));
+    }
+    AudioPipelineConfig::reload();
+
+    auto vadDetector = std::make_shared<VADDetector>();
+    if (!vadDetector->initialize())
+    {
+        return 1;
+    }
+
+    FileResult total;
+    for (const auto &path : options.files)
+    {
+        FileResult result = runFile(path, options, vadDetector);
+        printResult(path.filename().string(), result);
+        total.audioMs += result.audioMs;
+        total.wallMs += result.wallMs;
+        total.labels += result.labels;
+        total.detectedLabels += result.detectedLabels;
+        total.segments += result.segments;
+        total.matchedSegments += result.matchedSegments;
+        total.latenciesMs.insert(total.latenciesMs.end(),
+                                 result.latenciesMs.begin(),
+                                 result.latenciesMs.end());
+    }
+    printResult("total", total);
+
+    const EnergyGate &gate = vadDetector->energyGate();
+    std::printf("energy gate skipped %llu of %llu frames outside speech, "
+                "%s VAD kernels\n",
+                static_cast<unsigned long long>(gate.skippedFrames()),
+                static_cast<unsigned long long>(gate.measuredFrames()),
+                WebRtcVad_SimdName());
+    return 0;
+}
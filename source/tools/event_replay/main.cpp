@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <db/DatabaseManager.h>
+#include <kernel/Configuration.h>
+#include <kernel/EventBus.h>
+#include <kernel/EventRecorder.h>
+#include <kernel/IService.h>
+#include <kernel/Logger.h>
+#include <kernel/ServiceManager.h>
+
+namespace
+{
+// 回放时只启动不接触外部环境的服务：audio 会打开麦克风，weather 会发起网络请求。
+// AI 服务不初始化，录制中的识别结果等派生事件也不回放，回放不会访问模型接口
+const std::vector<std::string> kReplayServices = {"todo"};
+
+void printUsage(const char *program)
+{
+    std::printf("Usage: %s <recording> [--speed <factor>] [--max-speed]\n"
+                "  --speed <factor>  replay speed, 1 keeps the original "
+                "timing (default)\n"
+                "  --max-speed       publish events as fast as possible\n"
+                "Only source events are replayed, to the todo service and a "
+                "scratch database; events derived from them are produced "
+                "again by the services.\n",
+                program);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+    std::string recordingPath = argv[1];
+    double speed = 1.0;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--speed" && i + 1 < argc)
+        {
+            speed = std::atof(argv[++i]);
+        }
+        else if (arg == "--max-speed")
+        {
+            speed = 0;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    EventReplayer replayer;
+    if (!replayer.load(recordingPath))
+    {
+        return 1;
+    }
+
+    // 与主程序相同的内核启动流程，但不创建界面，也不改动真实的数据
+    auto &config = Configuration::getInstance();
+    config.loadFromFile();
+    // 不录制回放本身，否则录制路径指向被回放的文件时会把它清空
+    config.set("/app/event_bus/record_path",
+               Configuration::ConfigValueType(std::string()));
+
+    // 服务从程序所在目录加载
+    std::filesystem::path appPath = std::filesystem::canonical(argv[0]);
+    config.set("/app/working_dir",
+               Configuration::ConfigValueType(appPath.parent_path().string()));
+    // 数据库连接读取点分隔的 app.working_dir，把它指向临时目录，
+    // 回放写入的待办不会进入真实的数据库，回放结束后可以查看
+    std::filesystem::path scratchDir =
+        std::filesystem::temp_directory_path() /
+        ("event_replay_" +
+         std::to_string(
+             std::chrono::system_clock::now().time_since_epoch().count()));
+    std::filesystem::create_directories(scratchDir);
+    config.set("app.working_dir",
+               Configuration::ConfigValueType(scratchDir.string()));
+    DatabaseManager::getInstance().getTodoConnection();
+
+    auto configuredServices = std::get<std::vector<std::string>>(
+        config.get("/app/system_services",
+                   Configuration::ConfigValueType(std::vector<std::string>())));
+    std::vector<std::string> services;
+    for (const auto &service : configuredServices)
+    {
+        if (std::find(kReplayServices.begin(), kReplayServices.end(),
+                      service) != kReplayServices.end())
+        {
+            services.push_back(service);
+        }
+    }
+    config.set("/app/system_services",
+               Configuration::ConfigValueType(services));
+
+    auto &serviceManager = ServiceManager::getInstance();
+    for (const auto &service : serviceManager.loadSystemServices())
+    {
+        service->start();
+    }
+
+    auto &bus = EventBus::getInstance();
+    MetricsOptions metricsOptions;
+    metricsOptions.enabled = true;
+    bus.setMetricsOptions(metricsOptions);
+
+    auto startTime = std::chrono::steady_clock::now();
+    size_t published = replayer.replay(bus, speed);
+    bool drained = bus.flush(std::chrono::minutes(5));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+
+    Logger::logInfo("Replayed {} of {} recorded events in {} ms{}, scratch "
+                    "database in {}",
+                    published, replayer.records().size(), elapsed.count(),
+                    drained ? "" : " (not drained)", scratchDir.string());
+    std::printf("%s\n", bus.metrics().toJson().c_str());
+
+    serviceManager.unloadSystemServices();
+    return drained ? 0 : 2;
+}